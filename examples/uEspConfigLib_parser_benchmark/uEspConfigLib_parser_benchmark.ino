@@ -0,0 +1,113 @@
+/**
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Parser benchmark sketch
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ * 
+ * Currently storage classes are: SD-card, LittleFS, SPIFFS, EEPROM, RAM and none (values are lost after restart).
+ *
+ * This sketch compares loadConfigFile() streaming parser with the line based String parser used before it,
+ * loading the same config file from RAM so storage speed does not count.
+ *
+ *
+ * @file uEspConfigLib_parser_benchmark.ino
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+
+#include "Arduino.h"
+
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLib.h"
+
+#define BENCHMARK_OPTIONS 200
+#define BENCHMARK_RUNS 10
+
+uEspConfigLibFSMemory * configFs;
+uEspConfigLib * config;
+
+
+// Line parser used before uEspConfigLibParser, copied as it was
+void oldParseConfigLine(String line) {
+    int pos;
+    String variable, value;
+    line.trim();
+    if (line.startsWith(";") || line.startsWith("#") || line.startsWith("//")) { // comment line
+	    return;
+    }
+    pos = line.indexOf('=');
+    if (pos < 2) { // Not found or too short for sure, skip
+	    return;
+    }
+    variable = line.substring(0, pos - 1);
+    value = line.substring(pos + 1);
+    variable.trim();
+    value.trim();
+
+    config->set(variable.c_str(), value.c_str());
+}
+
+// loadConfigFile() as it was before uEspConfigLibParser
+bool oldLoadConfigFile() {
+	String line;
+    if (!configFs->openToRead()) {
+        return false;
+    }
+    while (configFs->readLine(&line)) {
+	    oldParseConfigLine(line);
+    }
+    configFs->closeFile();
+    return true;
+}
+
+void setup() {
+    char name[16];
+    char value[32];
+    unsigned long start;
+    unsigned long oldMicros = 0;
+    unsigned long newMicros = 0;
+
+    Serial.begin(115200);
+    delay(1000);
+
+    configFs = new uEspConfigLibFSMemory();
+    config = new uEspConfigLib(configFs);
+    for (int i = 0; i < BENCHMARK_OPTIONS; i++) {
+        snprintf(name, sizeof(name), "option_%d", i);
+        snprintf(value, sizeof(value), "value of option %d", i);
+        config->addOption(name, "Benchmark option", "default");
+        config->set(name, value);
+    }
+    config->saveConfigFile();
+
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        start = micros();
+        oldLoadConfigFile();
+        oldMicros += micros() - start;
+        yield();
+
+        start = micros();
+        config->loadConfigFile();
+        newMicros += micros() - start;
+        yield();
+    }
+
+    Serial.print("Config file: ");
+    Serial.print(BENCHMARK_OPTIONS);
+    Serial.print(" options, ");
+    Serial.print(strlen(configFs->data()));
+    Serial.println(" bytes");
+    Serial.print("String parser, average load microseconds: ");
+    Serial.println(oldMicros / BENCHMARK_RUNS);
+    Serial.print("Streaming parser, average load microseconds: ");
+    Serial.println(newMicros / BENCHMARK_RUNS);
+}
+
+void loop() {
+}
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""
+uEspConfigLib schema generator
+
+Reads an option schema file and writes a C++ header with constant option tables and a minimal perfect hash, to be
+used with uEspConfigLib::addSchema. Lookup must match uEspConfigLibSchema_find in src/uEspConfigLibSchema.h.
+
+Schema file is CSV, one option per line: name, type, default, flags, description
+  - type: string, int, bool or float
+  - flags: none or scanner (uEspConfigLib_OPTION_* names without prefix, joined with |)
+  - Empty lines and lines starting with # are ignored
+
+Usage: uEspConfigLib_schema.py schema.csv output.h [-n variable_name]
+
+@copyright Naguissa
+@author Naguissa
+@see https://github.com/Naguissa/uEspConfigLib
+@version 1.2.0
+"""
+import argparse
+import csv
+import os
+import string
+import sys
+
+TYPES = {
+    'string': 'uEspConfigLibSchema_TYPE_STRING',
+    'int': 'uEspConfigLibSchema_TYPE_INT',
+    'bool': 'uEspConfigLibSchema_TYPE_BOOL',
+    'float': 'uEspConfigLibSchema_TYPE_FLOAT',
+}
+
+FLAGS = {
+    'none': 'uEspConfigLib_OPTION_NONE',
+    'scanner': 'uEspConfigLib_OPTION_SCANNER',
+}
+
+MULTIPLIER = 2654435761
+MAX_DISPLACEMENT = 65535
+MAX_SEEDS = 1000
+
+
+def fnv1a(name, seed):
+    """Same hash as uEspConfigLibSchema_hash"""
+    value = seed
+    for byte in name.encode('utf-8'):
+        value = ((value ^ byte) * 16777619) & 0xffffffff
+    return value
+
+
+def slot(value, displacement, count):
+    """Same index as uEspConfigLibSchema_find"""
+    return (value ^ ((displacement * MULTIPLIER) & 0xffffffff)) % count
+
+
+def build_hash(names):
+    """Finds seed and displacements so every name gets its own slot (hash and displace)"""
+    count = len(names)
+    buckets = count // 2 + 1
+    for attempt in range(MAX_SEEDS):
+        seed = (2166136261 + attempt) & 0xffffffff
+        hashes = [fnv1a(name, seed) for name in names]
+        groups = [[] for _ in range(buckets)]
+        for index, value in enumerate(hashes):
+            groups[value % buckets].append(index)
+        displacements = [0] * buckets
+        used = [None] * count
+        failed = False
+        for bucket in sorted(range(buckets), key=lambda b: -len(groups[b])):
+            if not groups[bucket]:
+                break
+            for displacement in range(MAX_DISPLACEMENT + 1):
+                slots = [slot(hashes[index], displacement, count) for index in groups[bucket]]
+                if len(set(slots)) == len(slots) and all(used[s] is None for s in slots):
+                    break
+            else:
+                failed = True
+                break
+            displacements[bucket] = displacement
+            for index, s in zip(groups[bucket], slots):
+                used[s] = index
+        if not failed:
+            return seed, displacements, used
+    raise ValueError('No perfect hash found, check for duplicated names')
+
+
+def c_string(value):
+    return '"' + value.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def read_schema(path):
+    options = []
+    names = set()
+    with open(path, newline='', encoding='utf-8') as schema:
+        for number, row in enumerate(csv.reader(schema, skipinitialspace=True), 1):
+            if not row or not row[0].strip() or row[0].lstrip().startswith('#'):
+                continue
+            if len(row) < 5:
+                raise ValueError('%s:%d: expected name, type, default, flags, description' % (path, number))
+            name, kind, default, flags = (field.strip() for field in row[:4])
+            description = ', '.join(row[4:]).strip()
+            if kind not in TYPES:
+                raise ValueError('%s:%d: unknown type "%s"' % (path, number, kind))
+            for flag in flags.split('|'):
+                if flag.strip() not in FLAGS:
+                    raise ValueError('%s:%d: unknown flag "%s"' % (path, number, flag))
+            if name in names:
+                raise ValueError('%s:%d: duplicated name "%s"' % (path, number, name))
+            names.add(name)
+            options.append((name, kind, default, flags, description))
+    if not options:
+        raise ValueError('%s: no options defined' % path)
+    return options
+
+
+def main():
+    parser = argparse.ArgumentParser(description='uEspConfigLib schema generator')
+    parser.add_argument('schema', help='schema CSV file')
+    parser.add_argument('output', help='generated header')
+    parser.add_argument('-n', '--name', default='configSchema', help='schema variable name')
+    args = parser.parse_args()
+
+    try:
+        options = read_schema(args.schema)
+        seed, displacements, order = build_hash([option[0] for option in options])
+    except (OSError, ValueError) as error:
+        sys.stderr.write('uEspConfigLib_schema: %s\n' % error)
+        return 1
+
+    rows = []
+    for name, kind, default, flags, description in options:
+        flags = ' | '.join(FLAGS[flag.strip()] for flag in flags.split('|'))
+        rows.append('    {%s, %s, %s, %s, %s}' % (c_string(name), c_string(description), c_string(default), TYPES[kind], flags))
+
+    template_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'uEspConfigLib_schema.h.in')
+    with open(template_path, encoding='utf-8') as template:
+        header = string.Template(template.read()).substitute(
+            source=os.path.basename(args.schema),
+            name=args.name,
+            count=len(options),
+            buckets=len(displacements),
+            seed='0x%08xUL' % seed,
+            options=',\n'.join(rows),
+            indexes=', '.join(str(index) for index in order),
+            displacements=', '.join(str(value) for value in displacements),
+        )
+    with open(args.output, 'w', encoding='utf-8') as output:
+        output.write(header)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
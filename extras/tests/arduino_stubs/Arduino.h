@@ -0,0 +1,97 @@
+// Minimal Arduino core for host tests: only what uEspConfigLib uses
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+
+typedef uint8_t byte;
+
+// Test clock: millis() advances one millisecond on each call, micros() only when tests change it
+extern unsigned long stub_micros;
+extern unsigned long stub_yields;
+inline void yield() { stub_yields++; }
+inline unsigned long millis() { static unsigned long now = 0; return now++; }
+inline unsigned long micros() { return stub_micros; }
+inline void delay(unsigned long) {}
+
+#define SS 5
+
+class String {
+    public:
+        String() {}
+        String(const char * c) : s(c != 0 ? c : "") {}
+        String(const std::string & c) : s(c) {}
+        String(int v) : s(std::to_string(v)) {}
+        String(unsigned int v) : s(std::to_string(v)) {}
+        String(long v) : s(std::to_string(v)) {}
+        String(unsigned long v) : s(std::to_string(v)) {}
+        String(int v, unsigned char base) { char b[40]; snprintf(b, sizeof(b), base == 16 ? "%x" : "%d", v); s = b; }
+        String(unsigned long v, unsigned char base) { char b[40]; snprintf(b, sizeof(b), base == 16 ? "%lx" : "%lu", v); s = b; }
+        unsigned int length() const { return s.size(); }
+        const char * c_str() const { return s.c_str(); }
+        void trim() {
+            size_t start = s.find_first_not_of(" \t\r\n\v\f");
+            size_t end = s.find_last_not_of(" \t\r\n\v\f");
+            s = start == std::string::npos ? "" : s.substr(start, end - start + 1);
+        }
+        bool startsWith(const String & p) const { return s.rfind(p.s, 0) == 0; }
+        int indexOf(char c) const { size_t p = s.find(c); return p == std::string::npos ? -1 : (int) p; }
+        int indexOf(const char * c) const { size_t p = s.find(c); return p == std::string::npos ? -1 : (int) p; }
+        String substring(unsigned a, unsigned b = 0xFFFFFFFF) const { return String(s.substr(a, b - a)); }
+        void remove(unsigned i) { s.erase(i); }
+        void remove(unsigned i, unsigned n) { s.erase(i, n); }
+        bool concat(char c) { s.push_back(c); return true; }
+        bool concat(const char * c) { s += c; return true; }
+        bool concat(const char * c, unsigned int n) { s.append(c, n); return true; }
+        void toCharArray(char * b, unsigned n) const { strncpy(b, s.c_str(), n); }
+        bool reserve(unsigned n) { s.reserve(n); return true; }
+        bool operator==(const char * o) const { return s == o; }
+        bool operator==(const String & o) const { return s == o.s; }
+        String & operator+=(const String & o) { s += o.s; return *this; }
+        String & operator+=(const char * o) { s += o; return *this; }
+        String & operator+=(char o) { s += o; return *this; }
+        char operator[](unsigned i) const { return s[i]; }
+        std::string s;
+};
+inline String operator+(const String & a, const String & b) { return String(a.s + b.s); }
+inline String operator+(const String & a, const char * b) { return String(a.s + b); }
+inline String operator+(const char * a, const String & b) { return String(a + b.s); }
+inline String operator+(const String & a, int b) { return String(a.s + std::to_string(b)); }
+inline String operator+(const String & a, long b) { return String(a.s + std::to_string(b)); }
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t) { return 1; }
+        virtual size_t write(const uint8_t *, size_t n) { return n; }
+        size_t write(const char * c, size_t n) { return write((const uint8_t *) c, n); }
+        size_t print(const char * c) { return write((const uint8_t *) c, strlen(c)); }
+        size_t print(const String & c) { return write((const uint8_t *) c.c_str(), c.length()); }
+        size_t print(unsigned long v, int = 10) { return print(String(v)); }
+        size_t print(long v, int = 10) { return print(String(v)); }
+        size_t print(int v, int = 10) { return print(String(v)); }
+        size_t print(unsigned int v, int = 10) { return print(String(v)); }
+        size_t println(const char * c = "") { return print(c) + print("\n"); }
+        size_t println(unsigned long v, int = 10) { return print(v) + print("\n"); }
+        size_t println(int v, int = 10) { return print(v) + print("\n"); }
+        size_t printf(const char *, ...) { return 0; }
+};
+
+class Stream : public Print {
+    public:
+        virtual int available() { return 0; }
+        virtual int read() { return -1; }
+        virtual int peek() { return -1; }
+        size_t readBytes(char *, size_t) { return 0; }
+        size_t readBytes(uint8_t *, size_t) { return 0; }
+        String readStringUntil(char) { return String(); }
+};
+
+class HardwareSerial : public Stream {
+    public:
+        void begin(unsigned long) {}
+};
+extern HardwareSerial Serial;
@@ -0,0 +1,31 @@
+// Web server stub for host tests: handlers are driven through uEspConfigLibWebRequestMock instead
+#pragma once
+#include <Arduino.h>
+#include "WiFi.h"
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+struct HTTPUpload {
+    HTTPUploadStatus status;
+    String filename;
+    size_t totalSize;
+    size_t currentSize;
+    uint8_t buf[1436];
+};
+
+class ESP8266WebServer {
+    public:
+        String arg(const String &) { return String(); }
+        bool hasArg(const String &) { return false; }
+        void setContentLength(size_t) {}
+        void send(int, const char *, const String &) {}
+        void send(int, const char *, const char *) {}
+        void sendHeader(const String &, const String &, bool = false) {}
+        void sendContent(const String &) {}
+        void sendContent(const char *) {}
+        void sendContent(const char *, size_t) {}
+        WiFiClient client() { return WiFiClient(); }
+        HTTPUpload & upload() { static HTTPUpload u; return u; }
+};
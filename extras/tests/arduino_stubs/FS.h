@@ -0,0 +1,41 @@
+// File system stub for host tests: files are always empty, tests use RAM storages
+#pragma once
+#include <Arduino.h>
+
+namespace fs {
+class File : public Stream {
+    public:
+        using Print::write;
+        size_t write(const uint8_t *, size_t n) override { return n; }
+        size_t read(uint8_t *, size_t) { return 0; }
+        int read() override { return -1; }
+        int available() override { return 0; }
+        size_t size() { return 0; }
+        bool seek(uint32_t) { return true; }
+        void flush() {}
+        void close() {}
+        bool isDirectory() { return false; }
+        operator bool() const { return true; }
+};
+
+class FS {
+    public:
+        bool begin(bool = false) { begins++; if (failBegins > 0) { failBegins--; return false; } return true; }
+        bool format() { formats++; return true; }
+        File open(const char *, const char *) { return File(); }
+        bool exists(const char *) { return true; }
+        bool remove(const char *) { return true; }
+        bool rename(const char *, const char *) { return true; }
+        void end() { ends++; }
+        // Calls counted for mount tests; failBegins makes that many next begin() calls fail
+        int begins = 0;
+        int formats = 0;
+        int ends = 0;
+        int failBegins = 0;
+};
+}
+using fs::File;
+
+#ifndef ARDUINO_ARCH_ESP32
+    extern fs::FS SPIFFS;
+#endif
@@ -0,0 +1,28 @@
+// NVS Preferences stub for host tests: string records in memory, with ESP32 getString() return values
+#pragma once
+#include <Arduino.h>
+#include <map>
+
+extern std::map<std::string, std::string> stub_preferences;
+
+class Preferences {
+    public:
+        bool begin(const char *, bool = false) { return true; }
+        void end() {}
+        size_t getString(const char * key, char * value, size_t maxLen) {
+            auto record = stub_preferences.find(key);
+            if (record == stub_preferences.end() || record->second.size() + 1 > maxLen) {
+                return 0;
+            }
+            memcpy(value, record->second.c_str(), record->second.size() + 1);
+            return record->second.size() + 1;
+        }
+        String getString(const char * key, String defaultValue = String()) {
+            auto record = stub_preferences.find(key);
+            return record == stub_preferences.end() ? defaultValue : String(record->second);
+        }
+        size_t putString(const char * key, const char * value) { stub_preferences[key] = value; return strlen(value); }
+        bool remove(const char * key) { return stub_preferences.erase(key) > 0; }
+        bool isKey(const char * key) { return stub_preferences.count(key) > 0; }
+        bool clear() { stub_preferences.clear(); return true; }
+};
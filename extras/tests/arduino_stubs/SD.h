@@ -0,0 +1,11 @@
+#pragma once
+#include "FS.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+
+class SDClass : public fs::FS {
+    public:
+        bool begin(uint8_t) { return FS::begin(); }
+};
+extern SDClass SD;
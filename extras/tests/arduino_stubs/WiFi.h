@@ -0,0 +1,20 @@
+#pragma once
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "WiFiClient.h"
+
+extern std::vector<std::string> stub_networks; // SSIDs found by scanNetworks()
+
+enum { WIFI_AUTH_OPEN, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK, WIFI_AUTH_WPA_WPA2_PSK, WIFI_AUTH_WPA2_ENTERPRISE, WIFI_AUTH_WPA3_PSK, WIFI_AUTH_WPA2_WPA3_PSK, WIFI_AUTH_WAPI_PSK };
+enum { ENC_TYPE_WEP, ENC_TYPE_TKIP, ENC_TYPE_CCMP, ENC_TYPE_NONE, ENC_TYPE_AUTO };
+
+class WiFiClass {
+    public:
+        int scanNetworks() { return stub_networks.size(); }
+        String SSID(int i) { return String(stub_networks[i].c_str()); }
+        int channel(int) { return 0; }
+        int RSSI(int) { return 0; }
+        int encryptionType(int) { return 0; }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,18 @@
+// Network client stub for host tests: output is appended to stub_clientOut, writability is polled on stub_clientFd
+#pragma once
+#include <Arduino.h>
+
+extern int stub_clientFd;
+extern std::string stub_clientOut;
+
+class WiFiClient : public Stream {
+    public:
+        using Print::write;
+        size_t write(const uint8_t * data, size_t n) override { stub_clientOut.append((const char *) data, n); return n; }
+        bool connected() { return true; }
+        void stop() {}
+        void setNoDelay(bool) {}
+        int availableForWrite() { return 1000; }
+        int fd() { return stub_clientFd; }
+        operator bool() { return true; }
+};
@@ -0,0 +1,25 @@
+#include <Arduino.h>
+#include "WiFi.h"
+#include "LittleFS.h"
+#include "SD.h"
+#include "uEEPROMLib.h"
+#include "Preferences.h"
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+fs::FS LittleFS;
+fs::FS SPIFFS;
+SDClass SD;
+
+unsigned long stub_micros = 0;
+unsigned long stub_yields = 0;
+int stub_clientFd = -1;
+std::string stub_clientOut;
+byte stub_eeprom[4096];
+unsigned long stub_eepromWrites = 0;
+std::map<std::string, std::string> stub_preferences;
+std::vector<std::string> stub_networks;
+
+static struct StubEepromBlank { // Blank chip reads as 0xFF
+    StubEepromBlank() { memset(stub_eeprom, 0xFF, sizeof(stub_eeprom)); }
+} stubEepromBlank;
@@ -0,0 +1,10 @@
+// FreeRTOS mutexes mapped to std::recursive_mutex, so concurrent mode can be tested with threads
+#pragma once
+#include <mutex>
+
+typedef void * SemaphoreHandle_t;
+#define portMAX_DELAY 0xFFFFFFFF
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return (void *) new std::recursive_mutex(); }
+inline int xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, unsigned) { ((std::recursive_mutex *) mutex)->lock(); return 1; }
+inline int xSemaphoreGiveRecursive(SemaphoreHandle_t mutex) { ((std::recursive_mutex *) mutex)->unlock(); return 1; }
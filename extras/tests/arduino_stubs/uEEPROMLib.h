@@ -0,0 +1,29 @@
+// EEPROM stub for host tests: one 4KB chip shared by all objects, each write advances micros() as a 5ms I2C page write cycle
+#pragma once
+#include <Arduino.h>
+
+#define UEEPROMLIB_ADDRESS 0x57
+
+extern byte stub_eeprom[4096];
+extern unsigned long stub_eepromWrites;
+
+class uEEPROMLib {
+    public:
+        uEEPROMLib(uint8_t) {}
+        bool eeprom_read(const unsigned int address, byte * data, const unsigned int n) {
+            if (address + n > sizeof(stub_eeprom)) {
+                return false;
+            }
+            memcpy(data, stub_eeprom + address, n);
+            return true;
+        }
+        bool eeprom_write(const unsigned int address, void * data, const unsigned int n) {
+            if (address + n > sizeof(stub_eeprom)) {
+                return false;
+            }
+            memcpy(stub_eeprom + address, data, n);
+            stub_micros += 5000;
+            stub_eepromWrites++;
+            return true;
+        }
+};
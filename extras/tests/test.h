@@ -0,0 +1,27 @@
+// Minimal test helpers: each test_*.cpp is a program that aborts on first failed check
+#pragma once
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(condition) do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+#define CHECK_STR(actual, expected) do { \
+        const char * checkActual = (actual); \
+        const char * checkExpected = (expected); \
+        if (checkActual == 0 || strcmp(checkActual, checkExpected) != 0) { \
+            fprintf(stderr, "%s:%d: check failed: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, #actual, checkActual != 0 ? checkActual : "(null)", checkExpected); \
+            exit(1); \
+        } \
+    } while (0)
+
+#define RUN(test) do { \
+        test(); \
+        printf("  %s\n", #test); \
+    } while (0)
@@ -0,0 +1,104 @@
+// Compressed storage: exact round trip of any text, long values across window and comments not stored
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSCompressed.h"
+#include "uEspConfigLibFSMemory.h"
+#include <string>
+
+static std::string readAll(uEspConfigLibFSInterface * fs) {
+    char chunk[50];
+    size_t len;
+    std::string content;
+    CHECK(fs->openToRead());
+    while ((len = fs->read(chunk, sizeof(chunk))) > 0) {
+        content.append(chunk, len);
+    }
+    fs->closeFile();
+    return content;
+}
+
+static void addOptions(uEspConfigLib * config) {
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    config->addOption("url", "Server URL", "http://x/?k=v");
+}
+
+static void testRoundTrip() {
+    std::string text = "a = 1\nmark = \x01\x01 literal\n";
+    text += "run = " + std::string(600, 'r') + "\n"; // Matches longer than maximum length
+    text += "long = ";
+    for (unsigned int i = 0; i < 1000; i++) { // Repeats every 300 bytes, beyond window
+        text += (char) ('a' + (i % 300) % 26 + (i % 300) / 26 % 2);
+    }
+    text += "\nend = \x01\n";
+    uEspConfigLibFSMemory memory;
+    uEspConfigLibFSCompressed fs(&memory);
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text.substr(0, 700).c_str())); // Split writes
+    CHECK(fs.write(text.substr(700).c_str()));
+    CHECK(fs.closeFile());
+    CHECK(memory.length() < text.size());
+    CHECK(readAll(&fs) == text);
+
+    String line;
+    CHECK(fs.openToRead());
+    CHECK(fs.readLine(&line));
+    CHECK(line == "a = 1");
+    fs.closeFile();
+}
+
+static void testPlainTextReadable() {
+    uEspConfigLibFSMemory memory;
+    CHECK(memory.openToWrite());
+    CHECK(memory.write("ssid = plain\n"));
+    CHECK(memory.closeFile());
+    uEspConfigLibFSCompressed fs(&memory);
+    CHECK(readAll(&fs) == "ssid = plain\n");
+}
+
+static void testCommentsStripped() {
+    uEspConfigLibFSMemory memory;
+    uEspConfigLibFSCompressed fs(&memory);
+    CHECK(fs.openToWrite());
+    CHECK(fs.write("# Header\n; other\n\n// third\na = 1\n"));
+    CHECK(fs.write("url = http://x/y # kept\n"));
+    CHECK(fs.closeFile());
+    CHECK(readAll(&fs) == "a = 1\nurl = http://x/y # kept\n");
+}
+
+static void testConfigRoundTrip() {
+    std::string value;
+    for (unsigned int i = 0; i < 400; i++) {
+        value += (char) ('0' + i * 7 % 75);
+    }
+    uEspConfigLibFSMemory plain;
+    uEspConfigLib reference(&plain);
+    addOptions(&reference);
+    reference.set("ssid", "home");
+    reference.set("pass", value.c_str());
+    CHECK(reference.saveConfigFile());
+
+    uEspConfigLibFSMemory memory;
+    uEspConfigLibFSCompressed fs(&memory);
+    uEspConfigLib saved(&fs);
+    addOptions(&saved);
+    saved.set("ssid", "home");
+    saved.set("pass", value.c_str());
+    CHECK(saved.saveConfigFile());
+    CHECK(memory.length() * 2 < plain.length()); // Default format, comments are most of it
+
+    uEspConfigLib loaded(&fs);
+    addOptions(&loaded);
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("ssid"), "home");
+    CHECK(loaded.getPointer("pass") == value);
+    CHECK_STR(loaded.getPointer("url"), "http://x/?k=v");
+}
+
+int main() {
+    RUN(testRoundTrip);
+    RUN(testPlainTextReadable);
+    RUN(testCommentsStripped);
+    RUN(testConfigRoundTrip);
+    return 0;
+}
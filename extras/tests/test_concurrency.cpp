@@ -0,0 +1,109 @@
+// Concurrent mode: readers on other threads copy whole values while options change and old values are freed
+// Run under address sanitizer, a value freed while still being copied is reported as use after free.
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include <atomic>
+#include <thread>
+
+// Every value written is its length repeated as a character, so a torn copy is detected
+static bool valid(const char * value) {
+    size_t len = strlen(value);
+    if (len == 0) {
+        return true; // Default
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (value[i] != (char) ('a' + len % 26)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testReadersWhileWriting() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib config(&fs);
+    config.addOption("a", "Option a", "");
+    config.addOption("b", "Option b", "");
+    config.setConcurrentMode(true);
+    std::atomic<bool> done(false);
+    std::atomic<unsigned long> reads(0);
+    std::atomic<bool> failed(false);
+
+    auto reader = [&]() {
+        char buffer[80];
+        while (!done) {
+            if (!config.get(reads % 2 ? "a" : "b", buffer, sizeof(buffer)) || !valid(buffer)) {
+                failed = true;
+            }
+            reads++;
+        }
+    };
+    auto handler = [&]() {
+        while (!done) {
+            uEspConfigLibWebRequestMock request;
+            config.handleConfigRequestJson(&request);
+            if (request.code != 200 || request.body.indexOf("]}") < 0) {
+                failed = true;
+            }
+        }
+    };
+    std::thread readers[] = {std::thread(reader), std::thread(reader), std::thread(handler)};
+
+    char value[64];
+    uint32_t version = config.version();
+    unsigned int i;
+    for (i = 0; i < 4000 || reads < 4000; i++) { // Until readers had time to overlap with writes
+        size_t len = 1 + i % 60;
+        memset(value, 'a' + len % 26, len);
+        value[len] = 0;
+        CHECK(config.set(i % 2 ? "a" : "b", value));
+        if (i % 100 == 0) {
+            config.loop(); // Frees old values no reader can be copying
+        }
+    }
+    done = true;
+    for (std::thread & thread : readers) {
+        thread.join();
+    }
+    CHECK(!failed);
+    CHECK(config.version() == version + i);
+    config.loop();
+    CHECK(valid(config.getPointer("a")));
+}
+
+static void testSaveWhileWriting() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib config(&fs);
+    config.addOption("a", "Option a", "");
+    config.setConcurrentMode(true);
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        char value[64];
+        for (unsigned int i = 0; !done; i++) {
+            size_t len = 1 + i % 60;
+            memset(value, 'a' + len % 26, len);
+            value[len] = 0;
+            config.set("a", value);
+        }
+    });
+    for (unsigned int i = 0; i < 200; i++) {
+        CHECK(config.saveConfigFile());
+        const char * line = strstr(fs.data(), "\na = ");
+        CHECK(line != 0);
+        char stored[64] = "";
+        sscanf(line + 5, "%63[^\n]", stored);
+        CHECK(valid(stored));
+    }
+    done = true;
+    writer.join();
+}
+
+int main() {
+#ifdef ARDUINO_ARCH_ESP32 // Concurrent mode is only available on ESP32
+    RUN(testReadersWhileWriting);
+    RUN(testSaveWhileWriting);
+#endif
+    return 0;
+}
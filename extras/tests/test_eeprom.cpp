@@ -0,0 +1,115 @@
+// EEPROM storage: page-aligned writes, unchanged pages skipped and only written bytes counted
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSEEPROM.h"
+
+static void blank() {
+    memset(stub_eeprom, 0xFF, sizeof(stub_eeprom));
+    stub_eepromWrites = 0;
+}
+
+static String readAll(uEspConfigLibFSEEPROM * fs) {
+    char chunk[50];
+    size_t len;
+    String content;
+    CHECK(fs->openToRead());
+    while ((len = fs->read(chunk, sizeof(chunk) - 1)) > 0) {
+        chunk[len] = 0;
+        content += chunk;
+    }
+    fs->closeFile();
+    return content;
+}
+
+static void testCommentsStripped() {
+    blank();
+    uEspConfigLibFSEEPROM fs;
+    CHECK(fs.openToWrite());
+    CHECK(fs.write("# Header\n; other\n// third\na = 1\n"));
+    CHECK(fs.write("url = http://x/y # kept\n"));
+    CHECK(fs.closeFile());
+    CHECK(readAll(&fs) == "a = 1\nurl = http://x/y # kept\n");
+}
+
+static void testPageAligned() {
+    char text[101];
+    blank();
+    memset(text, 'x', 100);
+    text[100] = 0;
+    uEspConfigLibFSEEPROM fs;
+    fs.setPageSize(32);
+    fs.setStartAddress(30);
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text));
+    CHECK(fs.closeFile());
+    CHECK(stub_eepromWrites == 5); // 30-31, 32-63, 64-95, 96-127 and 128-130 with end of file mark
+    CHECK(fs.bytesWritten() == 101);
+    CHECK(stub_eeprom[29] == 0xFF);
+    CHECK(stub_eeprom[130] == 0);
+    CHECK(readAll(&fs) == text);
+}
+
+static void testUnchangedPagesSkipped() {
+    char text[101];
+    blank();
+    memset(text, 'x', 100);
+    text[100] = 0;
+    uEspConfigLibFSEEPROM fs;
+    fs.setPageSize(32);
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text));
+    CHECK(fs.closeFile());
+    CHECK(stub_eepromWrites == 4);
+    CHECK(fs.bytesWritten() == 101);
+
+    CHECK(fs.openToWrite()); // Same content: nothing written, nor counted
+    CHECK(fs.write(text));
+    CHECK(fs.closeFile());
+    CHECK(stub_eepromWrites == 4);
+    CHECK(fs.bytesWritten() == 101);
+
+    text[40] = 'y'; // Only second page changes
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text));
+    CHECK(fs.closeFile());
+    CHECK(stub_eepromWrites == 5);
+    CHECK(fs.bytesWritten() == 101 + 32);
+
+    fs.setCompareBeforeWrite(false);
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text));
+    CHECK(fs.closeFile());
+    CHECK(stub_eepromWrites == 9);
+    CHECK(fs.bytesWritten() == 101 + 32 + 101);
+    CHECK(readAll(&fs) == text);
+}
+
+static void testConfigRoundTrip() {
+    blank();
+    uEspConfigLibFSEEPROM fs;
+    uEspConfigLib config(&fs);
+    config.addOption("ssid", "WiFi SSID", "default");
+    config.addOption("pass", "WiFi password", "");
+    config.set("ssid", "home");
+    CHECK(config.saveConfigFile());
+    unsigned long writes = stub_eepromWrites;
+    CHECK(strstr((const char *) stub_eeprom, "ssid = home\n") != 0);
+    CHECK(strchr((const char *) stub_eeprom, '#') == 0);
+    CHECK(config.saveConfigFile()); // Unchanged file wears nothing
+    CHECK(stub_eepromWrites == writes);
+
+    uEspConfigLibFSEEPROM other;
+    uEspConfigLib loaded(&other);
+    loaded.addOption("ssid", "WiFi SSID", "default");
+    loaded.addOption("pass", "WiFi password", "");
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("ssid"), "home");
+}
+
+int main() {
+    RUN(testCommentsStripped);
+    RUN(testPageAligned);
+    RUN(testUnchangedPagesSkipped);
+    RUN(testConfigRoundTrip);
+    return 0;
+}
@@ -0,0 +1,182 @@
+// Server-sent events: changes pushed from loop(), partial writes kept for slow clients and never blocking
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include <string>
+#ifdef ARDUINO_ARCH_ESP32
+    #include <fcntl.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    return config;
+}
+
+// Every event is whole: "event: " line, "data: " line and empty line
+static bool wholeEvents(const std::string & body) {
+    size_t position = 0;
+    while (position < body.size()) {
+        size_t end = body.find("\n\n", position);
+        if (end == std::string::npos) {
+            return false;
+        }
+        std::string event = body.substr(position, end - position);
+        if (event.rfind("event: ", 0) != 0 && event.rfind(": keep-alive", 0) != 0) {
+            return false;
+        }
+        position = end + 2;
+    }
+    return true;
+}
+
+static void testChangeEvents() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigEvents(&request);
+    CHECK(request.code == 200);
+    CHECK(request.contentType == "text/event-stream");
+    CHECK(request.stream != 0);
+    config->set("ssid", "say \"hi\"");
+    config->set("ssid", "joined");
+    config->loop();
+    CHECK(request.stream->body == "event: change\ndata: {\"name\":\"ssid\",\"value\":\"joined\"}\n\n");
+}
+
+static void testSlowClient() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigEvents(&request);
+    request.stream->room = 10; // Connection takes only part of the event
+    config->set("ssid", "home");
+    config->loop();
+    CHECK(request.stream->body.length() == 10);
+    config->set("pass", "secret");
+    config->loop();
+    CHECK(request.stream->body.length() == 10);
+    request.stream->room = (size_t) -1;
+    config->loop();
+    CHECK(request.stream->body == "event: change\ndata: {\"name\":\"ssid\",\"value\":\"home\"}\n\n"
+        "event: change\ndata: {\"name\":\"pass\",\"value\":\"secret\"}\n\n");
+}
+
+static void testBlockedClientReloads() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigEvents(&request);
+    request.stream->room = 100;
+    std::string value(uEspConfigLib_SSE_BUFFER_SIZE / 4, 'v');
+    for (uint8_t i = 0; i < 10; i++) { // More than client buffer while it is not reading
+        config->set(i % 2 ? "ssid" : "pass", (value + (char) ('a' + i)).c_str());
+        config->loop();
+    }
+    CHECK(config->getMetrics().heap > uEspConfigLib_SSE_BUFFER_SIZE / 2); // Kept events are counted
+    request.stream->room = (size_t) -1;
+    config->loop();
+    config->loop();
+    std::string body = request.stream->body.s;
+    CHECK(wholeEvents(body));
+    CHECK(body.find("event: reload\ndata: {}\n\n") != std::string::npos);
+    CHECK(body.size() < 10 * value.size());
+}
+
+static void testClients() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock requests[uEspConfigLib_SSE_CLIENTS];
+    for (uint8_t i = 0; i < uEspConfigLib_SSE_CLIENTS; i++) {
+        config->handleConfigEvents(&requests[i]);
+        CHECK(requests[i].code == 200);
+    }
+    uEspConfigLibWebRequestMock full;
+    config->handleConfigEvents(&full);
+    CHECK(full.code == 503);
+    CHECK(full.stream == 0);
+
+    requests[0].stream->open = false; // Closed connection frees its slot
+    config->loop();
+    uEspConfigLibWebRequestMock again;
+    config->handleConfigEvents(&again);
+    CHECK(again.code == 200);
+    config->set("ssid", "all");
+    config->loop();
+    CHECK(again.stream->body.indexOf("\"value\":\"all\"") >= 0);
+    CHECK(requests[1].stream->body == again.stream->body);
+}
+
+// Adapter of a server without long-lived responses
+class NoStreamRequest : public uEspConfigLibWebRequestMock {
+    public:
+        uEspConfigLibStream * openStream(const char *) { return 0; };
+};
+
+static void testStreamsNotSupported() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    NoStreamRequest request;
+    config->handleConfigEvents(&request);
+    CHECK(request.code == 501);
+    CHECK(request.ended);
+}
+
+// WebServer adapter: headers and events written to client connection without waiting for it
+static void testWebServerClient() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLib_WebServer server;
+    std::string received;
+#ifdef ARDUINO_ARCH_ESP32 // Socket written directly: a local socket pair with a small send buffer
+    int fds[2];
+    int size = 4096;
+    char chunk[512];
+    ssize_t len;
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    stub_clientFd = fds[0];
+    config->handleConfigEvents(&server);
+    std::string value(3000, 'v');
+    for (uint8_t i = 0; i < 20; i++) { // Far more than socket takes, loop() never blocks
+        config->set("ssid", (value + (char) ('a' + i)).c_str());
+        config->loop();
+    }
+    for (uint8_t i = 0; i < 200; i++) {
+        while ((len = read(fds[1], chunk, sizeof(chunk))) > 0) {
+            received.append(chunk, len);
+        }
+        config->loop();
+    }
+    stub_clientFd = -1;
+    close(fds[0]);
+    close(fds[1]);
+    CHECK(received.find("event: reload\ndata: {}\n\n") != std::string::npos);
+#else // ESP8266 client reports free send buffer
+    stub_clientOut.clear();
+    config->handleConfigEvents(&server);
+    config->set("ssid", "home");
+    config->loop();
+    received = stub_clientOut;
+#endif
+    CHECK(received.rfind("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n", 0) == 0);
+    size_t body = received.find("\r\n\r\n");
+    CHECK(body != std::string::npos);
+    CHECK(wholeEvents(received.substr(body + 4)));
+    CHECK(received.find("event: change\ndata: {\"name\":\"ssid\"") != std::string::npos);
+}
+
+int main() {
+    RUN(testChangeEvents);
+    RUN(testSlowClient);
+    RUN(testBlockedClientReloads);
+    RUN(testClients);
+    RUN(testStreamsNotSupported);
+    RUN(testWebServerClient);
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Config file download and upload: streamed in chunks, sent by length and parsed while it arrives
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include <string>
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    return config;
+}
+
+// Storage with fixed content, that may have any byte
+class BinaryStorage : public uEspConfigLibFSInterface {
+    public:
+        BinaryStorage(const std::string content) : _content(content) {};
+        bool openToRead() { _position = 0; return true; };
+        size_t read(char * buffer, const size_t size) {
+            size_t len = _content.size() - _position < size ? _content.size() - _position : size;
+            memcpy(buffer, _content.data() + _position, len);
+            _position += len;
+            return len;
+        };
+        bool closeFile() { return true; };
+
+    private:
+        std::string _content;
+        size_t _position = 0;
+};
+
+static void testDownload() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->set("ssid", "home"); // Pending change is saved before download
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigDownload(&request);
+    CHECK(request.code == 200);
+    CHECK(request.body == fs.data());
+    CHECK(request.body.indexOf("ssid = home\n") >= 0);
+
+    uEspConfigLibWebRequestMock missing;
+    missing.setArg("section", "none");
+    config->handleConfigDownload(&missing);
+    CHECK(missing.code == 404);
+
+    CHECK(config->beginLoad());
+    uEspConfigLibWebRequestMock busy;
+    config->handleConfigDownload(&busy);
+    CHECK(busy.code == 503);
+    while (config->stepLoad(1) == 0) {
+    }
+    uEspConfigLibWebRequestMock again;
+    config->handleConfigDownload(&again);
+    CHECK(again.code == 200);
+}
+
+static void testDownloadBinary() {
+    uEspConfigLibFSMemory fs;
+    std::string content("a = 1\n", 6);
+    content += std::string(3, '\0') + "after zero\n" + std::string(uEspConfigLib_READ_CHUNK_SIZE, 'x');
+    BinaryStorage binary(content);
+    uEspConfigLib * config = create(&fs);
+    config->addSection("bin", &binary);
+    uEspConfigLibWebRequestMock request;
+    request.setArg("section", "bin");
+    config->handleConfigDownload(&request);
+    CHECK(request.code == 200);
+    CHECK(request.body.s == content); // Whole file, null bytes included
+    CHECK(request.sentBytes() == content.size());
+}
+
+static void testDownloadRateLimited() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveRateLimit(1, 1000000);
+    uEspConfigLibWebRequestMock save;
+    save.setArg("ssid", "saved");
+    config->handleSaveConfig(&save);
+    CHECK(strstr(fs.data(), "ssid = saved\n") != 0);
+
+    config->set("ssid", "pending"); // No token left: stored file is sent and change is kept for later
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigDownload(&request);
+    CHECK(request.code == 200);
+    CHECK(request.body.indexOf("ssid = saved\n") >= 0);
+    CHECK(strstr(fs.data(), "pending") == 0);
+    CHECK(config->isDirty());
+
+    config->setSaveRateLimit(0, 0); // Unlimited: deferred change is saved from loop()
+    config->loop();
+    CHECK(strstr(fs.data(), "ssid = pending\n") != 0);
+    CHECK(!config->isDirty());
+}
+
+static void testImport() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    const char * file = "# Uploaded\nssid = up\nloaded\npass = 1234";
+    CHECK(config->beginImport());
+    CHECK(!config->beginImport());
+    for (size_t i = 0; i < strlen(file); i += 5) { // Chunks split names and values
+        CHECK(config->importChunk(file + i, strlen(file + i) < 5 ? strlen(file + i) : 5));
+    }
+    CHECK(config->endImport());
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigImport(&request);
+    CHECK(request.location == "/?saved=1");
+    CHECK_STR(config->getPointer("ssid"), "up");
+    CHECK_STR(config->getPointer("pass"), "1234");
+    CHECK(strstr(fs.data(), "pass = 1234\n") != 0);
+}
+
+int main() {
+    RUN(testDownload);
+    RUN(testDownloadBinary);
+    RUN(testDownloadRateLimited);
+    RUN(testImport);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Web handlers, driven through uEspConfigLibWebRequestMock
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    return config;
+}
+
+static void testHtmlForm() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->set("ssid", "home");
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigRequestHtml(&request, "/save");
+    CHECK(request.code == 200);
+    CHECK(request.contentType == "text/html");
+    CHECK(request.ended);
+    CHECK(request.body.indexOf("action=\"/save\"") >= 0);
+    CHECK(request.body.indexOf("name=\"ssid\" value=\"home\"") >= 0);
+    CHECK(request.body.indexOf("name=\"pass\" value=\"\"") >= 0);
+    CHECK(request.sentBytes() == request.body.length());
+}
+
+static void testJsonEscaping() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->set("ssid", "say \"hi\"\\\n");
+    uEspConfigLibWebRequestMock request;
+    config->handleConfigRequestJson(&request);
+    CHECK(request.code == 200);
+    CHECK(request.contentType == "application/vnd.api+json");
+    CHECK(request.body.indexOf("{\"name\":\"ssid\", \"description\":\"WiFi SSID\", \"defaultValue\":\"default\", \"value\":\"say \\\"hi\\\"\\\\\\n\"}") >= 0);
+    CHECK(request.body.indexOf("]}") == (int) request.body.length() - 2);
+}
+
+static void testSaveConfig() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock request;
+    request.setArg("ssid", "  office  ");
+    request.setArg("unknown", "ignored");
+    config->handleSaveConfig(&request);
+    CHECK(request.code == 302);
+    CHECK(request.location == "/?saved=1");
+    CHECK_STR(config->getPointer("ssid"), "office");
+    CHECK_STR(config->getPointer("pass"), ""); // Not sent, not changed
+    CHECK(strstr(fs.data(), "ssid = office\n") != 0);
+    CHECK(!config->isDirty());
+
+    uEspConfigLibWebRequestMock json;
+    json.setArg("format", "json");
+    json.setArg("pass", "");
+    config->handleSaveConfig(&json);
+    CHECK(json.code == 200);
+    CHECK(json.body == "{\"data\":{\"result\": 1}}");
+}
+
+static void testWifiScan() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock empty;
+    empty.setArg("option", "scan");
+    empty.setArg("field", "ssid");
+    config->handleConfigRequestHtml(&empty);
+    CHECK(empty.code == 200);
+    CHECK(empty.ended);
+    CHECK(empty.body.indexOf("No networks found") >= 0);
+
+    stub_networks = {"home", "office"};
+    uEspConfigLibWebRequestMock request;
+    request.setArg("option", "scan");
+    request.setArg("field", "ssid");
+    config->handleConfigRequestHtml(&request);
+    stub_networks.clear();
+    CHECK(request.ended);
+    CHECK(request.body.indexOf("getElementById('ssid').value='home'") >= 0);
+    CHECK(request.body.indexOf(">office - Channel: ") >= 0);
+    CHECK(request.body.indexOf("<form") < 0);
+}
+
+int main() {
+    RUN(testHtmlForm);
+    RUN(testJsonEscaping);
+    RUN(testSaveConfig);
+    RUN(testWifiScan);
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Incremental load: same values as whole load, changes done meanwhile kept, and guards while save or load is in progress
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include <string>
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    char name[8];
+    char value[8];
+    for (uint8_t i = 0; i < 20; i++) {
+        snprintf(name, sizeof(name), "opt%u", i);
+        snprintf(value, sizeof(value), "v%u", i);
+        config->addOption(strdup(name), "Option", strdup(value));
+    }
+    return config;
+}
+
+static void testStepLoad() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * saved = create(&fs);
+    saved->set("opt0", "a");
+    saved->set("opt19", "z");
+    CHECK(saved->saveConfigFile());
+
+    uEspConfigLib * config = create(&fs);
+    CHECK(config->stepLoad(1) == -1);
+    CHECK(config->beginLoad());
+    CHECK(!config->beginLoad());
+    CHECK(!config->isLoaded());
+    unsigned int calls = 0;
+    int8_t result;
+    while ((result = config->stepLoad(0)) == 0) { // 0 lines is taken as 1
+        calls++;
+        if (calls == 1) {
+            CHECK_STR(config->getPointer("opt19"), "v19"); // Not read yet
+            config->set("opt19", "set while loading");
+        }
+    }
+    CHECK(result == 100);
+    CHECK(calls > 20);
+    CHECK(config->isLoaded());
+    CHECK_STR(config->getPointer("opt0"), "a");
+    CHECK_STR(config->getPointer("opt19"), "set while loading"); // Changes done while loading are kept
+    CHECK(config->stepLoad(1) == -1);
+}
+
+static void testGuards() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->set("opt1", "saved");
+    CHECK(config->saveConfigFile());
+    std::string stored = fs.data();
+
+    // Saving while loading would overwrite values not read yet
+    CHECK(config->beginLoad());
+    CHECK(!config->beginSave());
+    CHECK(!config->saveConfigFile());
+    uEspConfigLibWebRequestMock request;
+    request.setArg("opt2", "posted");
+    config->handleSaveConfig(&request);
+    CHECK(request.location == "/?saved=1&deferred=1");
+    CHECK(stored == fs.data());
+    config->loop();
+    CHECK(stored == fs.data());
+    while (config->stepLoad(4) == 0) {
+    }
+    config->loop();
+    CHECK(strstr(fs.data(), "opt2 = posted\n") != 0);
+    CHECK(strstr(fs.data(), "opt1 = saved\n") != 0);
+    CHECK(!config->isDirty());
+
+    // Loading while saving would read a partial file
+    CHECK(config->beginSave());
+    CHECK(!config->beginLoad());
+    CHECK(!config->loadConfigFile());
+    CHECK(config->stepSave(8) == 0);
+    while (config->stepSave(8) < 100) {
+    }
+    CHECK(config->loadConfigFile());
+
+    // Full load aborts a pending incremental one
+    CHECK(config->beginLoad());
+    CHECK(config->stepLoad(1) == 0);
+    CHECK(config->loadConfigFile());
+    CHECK(config->stepLoad(1) == -1);
+    CHECK(config->saveConfigFile());
+}
+
+int main() {
+    RUN(testStepLoad);
+    RUN(testGuards);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Incremental save: same file as whole save, and changes done while it is in progress saved afterwards
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include <string>
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    char name[8];
+    char value[8];
+    for (uint8_t i = 0; i < 20; i++) {
+        snprintf(name, sizeof(name), "opt%u", i);
+        snprintf(value, sizeof(value), "v%u", i);
+        config->addOption(strdup(name), "Option", strdup(value));
+    }
+    return config;
+}
+
+static void testStepSaveMatchesSave() {
+    for (uint8_t flags = 0; flags <= (uEspConfigLib_SAVE_NONDEFAULT_ONLY | uEspConfigLib_SAVE_COMPACT); flags++) {
+        uEspConfigLibFSMemory whole;
+        uEspConfigLibFSMemory stepped;
+        uEspConfigLib * config = create(&whole);
+        uEspConfigLib * steps = create(&stepped);
+        config->setSaveFlags(flags);
+        steps->setSaveFlags(flags);
+        config->set("opt3", "changed");
+        steps->set("opt3", "changed");
+        CHECK(config->saveConfigFile());
+
+        CHECK(steps->beginSave());
+        CHECK(steps->isSaving());
+        int8_t progress = 0;
+        int8_t last = 0;
+        unsigned int calls = 0;
+        while ((progress = steps->stepSave(16)) < 100) {
+            CHECK(progress >= last && progress < 100);
+            last = progress;
+            calls++;
+        }
+        CHECK(calls > 5 || (flags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) != 0); // Only one option written when non-default only
+        CHECK(!steps->isSaving());
+        CHECK(steps->stepSave(16) == -1);
+        CHECK(std::string(stepped.data()) == whole.data());
+    }
+}
+
+static void testLoopStepSave() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveDelay(1);
+    config->setSaveStep(32);
+    config->set("opt5", "later");
+    unsigned int calls = 0;
+    while (config->isDirty() || config->isSaving()) {
+        config->loop();
+        calls++;
+        CHECK(calls < 1000);
+    }
+    CHECK(calls > 5);
+    CHECK(strstr(fs.data(), "opt5 = later\n") != 0);
+    CHECK(strstr(fs.data(), "opt19 = v19\n") != 0);
+}
+
+static void testPostedWhileSaving() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    CHECK(config->beginSave());
+    CHECK(config->stepSave(8) == 0);
+    uEspConfigLibWebRequestMock request;
+    request.setArg("opt4", "posted");
+    config->handleSaveConfig(&request);
+    CHECK(request.location == "/?saved=1&deferred=1");
+    CHECK(config->beginImport());
+    CHECK(config->importChunk("opt7 = imported\n", 16));
+    CHECK(config->endImport());
+    CHECK(!config->flush()); // Storage in use
+    while (config->stepSave(8) < 100) {
+    }
+    CHECK(config->isDirty());
+    config->loop();
+    CHECK(strstr(fs.data(), "opt4 = posted\n") != 0);
+    CHECK(strstr(fs.data(), "opt7 = imported\n") != 0);
+    CHECK(!config->isDirty());
+}
+
+int main() {
+    RUN(testStepSaveMatchesSave);
+    RUN(testLoopStepSave);
+    RUN(testPostedWhileSaving);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Key/value storages: one record per option, long values never truncated
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibKVMemory.h"
+#include "uEspConfigLibKVPreferences.h"
+#include <string>
+
+static void addOptions(uEspConfigLib * config) {
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    config->addOption("url", "Server URL", "http://x/?k=v");
+}
+
+static void testKeyValueRoundTrip() {
+    uEspConfigLibKVMemory kv;
+    uEspConfigLib saved(&kv);
+    addOptions(&saved);
+    saved.set("ssid", "home");
+    CHECK(saved.saveConfigFile());
+    unsigned long writes = kv.writes();
+    saved.set("pass", "secret");
+    CHECK(saved.flush());
+    CHECK(kv.writes() == writes + 1); // Changed option only
+
+    uEspConfigLib loaded(&kv);
+    addOptions(&loaded);
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("ssid"), "home");
+    CHECK_STR(loaded.getPointer("pass"), "secret");
+    CHECK_STR(loaded.getPointer("url"), "http://x/?k=v");
+}
+
+// Long values on any storage: get() refuses small buffers, load reads them whole
+static void checkLongValues(uEspConfigLibKVInterface * kv) {
+    std::string value(uEspConfigLibParser_VALUE_SIZE * 3, 'v');
+    char small[8];
+    CHECK(kv->put("pass", value.c_str()));
+    CHECK(kv->put("ssid", ""));
+    CHECK(kv->length("pass") == value.size());
+    CHECK(kv->length("ssid") == 0);
+    CHECK(kv->length("missing") == 0);
+    CHECK(!kv->get("pass", small, sizeof(small)));
+    CHECK(kv->get("ssid", small, sizeof(small)));
+    CHECK_STR(small, "");
+    CHECK(!kv->get("missing", small, sizeof(small)));
+
+    uEspConfigLib loaded(kv);
+    addOptions(&loaded);
+    CHECK(loaded.loadConfigFile());
+    CHECK(loaded.getPointer("pass") == value);
+    CHECK_STR(loaded.getPointer("ssid"), "");
+
+    uEspConfigLib stepped(kv);
+    addOptions(&stepped);
+    CHECK(stepped.beginLoad());
+    while (stepped.stepLoad(1) == 0) {
+    }
+    CHECK(stepped.getPointer("pass") == value);
+}
+
+static void testMemoryLongValues() {
+    uEspConfigLibKVMemory kv;
+    checkLongValues(&kv);
+}
+
+static void testPreferencesLongValues() {
+#ifdef ARDUINO_ARCH_ESP32
+    uEspConfigLibKVPreferences kv;
+    checkLongValues(&kv);
+#endif
+}
+
+int main() {
+    RUN(testKeyValueRoundTrip);
+    RUN(testMemoryLongValues);
+    RUN(testPreferencesLongValues);
+    return 0;
+}
@@ -0,0 +1,81 @@
+// RAM-image storage: save/load round trips and region validation
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+
+static void addOptions(uEspConfigLib * config) {
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    config->addOption("url", "Server URL", "http://x/?k=v");
+}
+
+static void testRoundTrip() {
+    for (uint8_t flags = 0; flags <= (uEspConfigLib_SAVE_NONDEFAULT_ONLY | uEspConfigLib_SAVE_COMPACT); flags++) {
+        uEspConfigLibFSMemory fs;
+        uEspConfigLib saved(&fs);
+        addOptions(&saved);
+        saved.setSaveFlags(flags);
+        saved.set("ssid", "home network");
+        saved.set("pass", "p=a#s s");
+        CHECK(saved.saveConfigFile());
+        CHECK(fs.length() > 0);
+        CHECK((strstr(fs.data(), "# ") == 0) == ((flags & uEspConfigLib_SAVE_COMPACT) != 0));
+        CHECK((strstr(fs.data(), "url") == 0) == ((flags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) != 0));
+
+        uEspConfigLib loaded(&fs);
+        addOptions(&loaded);
+        loaded.setSaveFlags(flags);
+        loaded.set("url", "changed before load");
+        CHECK(loaded.loadConfigFile());
+        CHECK(loaded.isLoaded());
+        CHECK_STR(loaded.getPointer("ssid"), "home network");
+        CHECK_STR(loaded.getPointer("pass"), "p=a#s s");
+        CHECK_STR(loaded.getPointer("url"), "http://x/?k=v"); // Stored default, or reset when not stored
+        CHECK(!loaded.isSchemaChanged());
+    }
+}
+
+static void testMissingFile() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib config(&fs);
+    addOptions(&config);
+    CHECK(!config.loadConfigFile());
+    CHECK(!config.isLoaded());
+    CHECK_STR(config.getPointer("ssid"), "default");
+}
+
+static void testRegion() {
+    static char region[64];
+    memset(region, 0x55, sizeof(region)); // Garbage, as RTC memory after power loss
+    uEspConfigLibFSMemory fs(region, sizeof(region));
+    CHECK(!fs.openToRead());
+    CHECK(fs.length() == 0);
+    CHECK_STR(fs.data(), "");
+
+    CHECK(fs.openToWrite());
+    CHECK(fs.write("a = 1\n"));
+    CHECK(!fs.write("this line does not fit on remaining region space at all\n"));
+    CHECK(fs.closeFile());
+
+    uEspConfigLibFSMemory again(region, sizeof(region)); // Content survives, as after a deep sleep
+    CHECK(again.length() == 6);
+    CHECK_STR(again.data(), "a = 1\n");
+    char line[8];
+    CHECK(again.openToRead());
+    CHECK(again.readLine(line, sizeof(line)));
+    CHECK_STR(line, "a = 1");
+    CHECK(!again.readLine(line, sizeof(line)));
+    again.closeFile();
+
+    memset(region + uEspConfigLibFSMemory_MAGIC_SIZE, 'x', sizeof(region) - uEspConfigLibFSMemory_MAGIC_SIZE); // No terminator left
+    CHECK(!again.openToRead());
+    again.clear();
+    CHECK(!uEspConfigLibFSMemory(region, sizeof(region)).openToRead());
+}
+
+int main() {
+    RUN(testRoundTrip);
+    RUN(testMissingFile);
+    RUN(testRegion);
+    return 0;
+}
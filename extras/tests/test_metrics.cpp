@@ -0,0 +1,53 @@
+// Metrics: loads, saves, requests and storage bytes in Prometheus text format
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    return config;
+}
+
+static void testMetrics() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    CHECK(config->saveConfigFile());
+    CHECK(config->loadConfigFile());
+    uEspConfigLibWebRequestMock form;
+    config->handleConfigRequestHtml(&form);
+    uEspConfigLibWebRequestMock request;
+    config->handleMetrics(&request);
+    CHECK(request.code == 200);
+    CHECK(request.body.indexOf("\nuespconfig_loads_total 1\n") >= 0);
+    CHECK(request.body.indexOf("\nuespconfig_saves_total 1\n") >= 0);
+    CHECK(request.body.indexOf("\nuespconfig_http_requests_total 1\n") >= 0);
+    CHECK(request.body.indexOf((String("\nuespconfig_http_response_bytes_total ") + (long) form.body.length() + "\n").c_str()) >= 0);
+
+    char line[128];
+    snprintf(line, sizeof(line), "uespconfig_storage_written_bytes_total{storage=\"main\",section=\"\",type=\"memory\"} %lu\n", (unsigned long) fs.length());
+    CHECK(request.body.indexOf(line) >= 0);
+}
+
+static void testErrors() {
+    char region[16];
+    uEspConfigLibFSMemory fs(region, sizeof(region)); // Too small for config file
+    uEspConfigLib * config = create(&fs);
+    CHECK(!config->loadConfigFile()); // Nothing stored
+    CHECK(!config->saveConfigFile());
+    CHECK(config->getMetrics().loadErrors == 1);
+    CHECK(config->getMetrics().saveErrors == 1);
+    uEspConfigLibWebRequestMock request;
+    config->handleMetrics(&request);
+    CHECK(request.body.indexOf("\nuespconfig_load_errors_total 1\n") >= 0);
+    CHECK(request.body.indexOf("\nuespconfig_save_errors_total 1\n") >= 0);
+    CHECK(request.body.indexOf("\n# TYPE uespconfig_saves_total counter\n") >= 0);
+}
+
+int main() {
+    RUN(testMetrics);
+    RUN(testErrors);
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Shared mounts: each filesystem is mounted once for all storages and instances, failed mounts are retried
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMount.h"
+#include "uEspConfigLibFSLittlefs.h"
+#include "uEspConfigLibFSSpiffs.h"
+#include "uEspConfigLibFSSd.h"
+
+static void testMountedOnce() {
+    uEspConfigLibFSLittlefs main("/main.ini", true);
+    uEspConfigLibFSLittlefs profile("/profile.ini", true);
+    uEspConfigLib first(&main);
+    uEspConfigLib second(&profile);
+    CHECK(LittleFS.begins == 1);
+    CHECK(uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_LITTLEFS));
+    CHECK(uEspConfigLibFSMount::mount(uEspConfigLibFSMount_LITTLEFS));
+    CHECK(LittleFS.begins == 1);
+    CHECK(!main.formatted());
+    CHECK(main.openToRead());
+    main.closeFile();
+
+    uEspConfigLibFSMount::unmount(uEspConfigLibFSMount_LITTLEFS);
+    CHECK(LittleFS.ends == 1);
+    CHECK(!uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_LITTLEFS));
+    uEspConfigLibFSMount::unmount(uEspConfigLibFSMount_LITTLEFS); // Not mounted: nothing to do
+    CHECK(LittleFS.ends == 1);
+    uEspConfigLibFSLittlefs again("/main.ini", true);
+    CHECK(LittleFS.begins == 2);
+}
+
+static void testFormatOnce() {
+    SPIFFS.failBegins = 1; // Unformatted: first begin fails
+    uEspConfigLibFSSpiffs first("/a.ini", true);
+    uEspConfigLibFSSpiffs second("/b.ini", true);
+    CHECK(SPIFFS.formats == 1);
+    CHECK(SPIFFS.begins == 2);
+    CHECK(uEspConfigLibFSMount::formatted(uEspConfigLibFSMount_SPIFFS));
+    CHECK(first.formatted());
+    CHECK(!second.formatted()); // Already mounted when created
+}
+
+static void testFailedMountRetried() {
+    SD.failBegins = 1; // No card
+    uEspConfigLibFSSd missing("/config.ini", true, 5);
+    CHECK(!uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_SD));
+    CHECK(!missing.openToRead());
+    CHECK(SD.formats == 0); // SD cards are never formatted
+    uEspConfigLibFSSd inserted("/config.ini", true, 5);
+    CHECK(uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_SD));
+    CHECK(SD.begins == 2);
+    CHECK(!uEspConfigLibFSMount::mount(uEspConfigLibFSMount_COUNT));
+    CHECK(!uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_COUNT));
+}
+
+int main() {
+    RUN(testMountedOnce);
+    RUN(testFormatOnce);
+    RUN(testFailedMountRetried);
+    return 0;
+}
@@ -0,0 +1,178 @@
+// uEspConfigLibParser: syntax edge cases, fed one character at a time as storages do, and long lines from storages
+#include "test.h"
+#include "uEspConfigLibParser.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include <string>
+
+// Feeds text and finishes file, returning "name=value;" for each pair found
+static std::string parse(const char * text) {
+    uEspConfigLibParser parser;
+    std::string pairs;
+    for (; *text != 0; text++) {
+        if (parser.feed(*text)) {
+            pairs += std::string(parser.name()) + "=" + parser.value() + ";";
+        }
+    }
+    if (parser.finish()) {
+        pairs += std::string(parser.name()) + "=" + parser.value() + ";";
+    }
+    return pairs;
+}
+
+static void testBasicSyntax() {
+    CHECK(parse("a = 1\nbb=two\n") == "a=1;bb=two;");
+    CHECK(parse("  a \t=\t 1 2  \n") == "a=1 2;");
+    CHECK(parse("a = 1\r\nb = 2\r\n") == "a=1;b=2;");
+    CHECK(parse("\n\n   \n\ta = 1\n\n") == "a=1;");
+}
+
+static void testComments() {
+    CHECK(parse("# a = 1\n; b = 2\n// c = 3\nd = 4\n") == "d=4;");
+    CHECK(parse("   # indented = comment\n") == "");
+    CHECK(parse("/path = 5\n") == "/path=5;"); // Single slash is part of name
+    CHECK(parse("a = 1 # not a comment\n") == "a=1 # not a comment;");
+}
+
+static void testValues() {
+    CHECK(parse("a =\nb = \n") == "a=;b=;");
+    CHECK(parse("url = http://x/?k=v\n") == "url=http://x/?k=v;");
+    CHECK(parse("a = 1") == "a=1;"); // No line ending at end of file
+}
+
+static void testInvalidLines() {
+    CHECK(parse("= 1\nnovalue\n  = 2\nok = 3\n") == "ok=3;");
+}
+
+static void testLongEntriesAreNotTruncated() {
+    std::string name(uEspConfigLibParser_NAME_SIZE * 2, 'n');
+    std::string value(uEspConfigLibParser_VALUE_SIZE * 5, 'v');
+    value[value.size() / 2] = ' ';
+    std::string text = name + " = " + value + "  \nshort = s\n";
+    CHECK(parse(text.c_str()) == name + "=" + value + ";short=s;");
+}
+
+static void testOverlongLinesDiscarded() {
+    std::string value(uEspConfigLibParser_MAX_SIZE, 'v');
+    std::string name(uEspConfigLibParser_MAX_SIZE, 'n');
+    std::string text = "a = " + value + "\nb = 2\n" + name + " = 3\nc = 4";
+    uEspConfigLibParser parser;
+    std::string pairs;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (parser.feed(text[i])) {
+            pairs += std::string(parser.name()) + "=" + parser.value() + ";";
+        }
+    }
+    CHECK(parser.finish());
+    CHECK(pairs == "b=2;");
+    CHECK_STR(parser.value(), "4");
+    CHECK(parser.discarded());
+    parser.reset();
+    CHECK(!parser.discarded());
+
+    value.resize(uEspConfigLibParser_MAX_SIZE - 1); // Longest value accepted
+    CHECK(parse(("a = " + value + "\n").c_str()) == "a=" + value + ";");
+}
+
+// Custom storage implementing only readLine(String *), as before raw reads existed
+class LineStorage : public uEspConfigLibFSInterface {
+    public:
+        LineStorage(const char * text) : _text(text) {}
+        bool openToRead() { _position = 0; return true; }
+        bool readLine(String * line) {
+            if (_text[_position] == 0) {
+                return false;
+            }
+            const char * eol = strchr(_text + _position, '\n');
+            size_t len = eol != 0 ? eol - _text - _position : strlen(_text + _position);
+            *line = String(std::string(_text + _position, len));
+            _position += len + (eol != 0 ? 1 : 0);
+            return true;
+        }
+        bool closeFile() { return true; }
+    private:
+        const char * _text;
+        size_t _position = 0;
+};
+
+static void testLineStorageRead() {
+    std::string value(600, 'v');
+    std::string text = "short = 1\nlong = " + value + "\nlast = 2";
+    LineStorage storage(text.c_str());
+    char chunk[16];
+    size_t len;
+    std::string content;
+    CHECK(storage.openToRead());
+    while ((len = storage.read(chunk, sizeof(chunk))) > 0) {
+        CHECK(len <= sizeof(chunk));
+        content.append(chunk, len);
+    }
+    CHECK(content == text + "\n");
+
+    uEspConfigLib config(&storage);
+    config.addOption("long", "Long value", "");
+    config.addOption("last", "Last value", "");
+    CHECK(config.loadConfigFile());
+    CHECK(config.getPointer("long") == value);
+    CHECK_STR(config.getPointer("last"), "2");
+
+    CHECK(config.beginLoad()); // Abandoned load does not leave content for next one
+    CHECK(config.stepLoad(1) == 0);
+    CHECK(config.loadConfigFile());
+    CHECK(config.getPointer("long") == value);
+}
+
+static void testOverlongLinesReported() {
+    std::string value(uEspConfigLibParser_MAX_SIZE, 'v');
+    std::string text = "a = " + value + "\nb = 2\n";
+    uEspConfigLibFSMemory fs;
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text.c_str()));
+    CHECK(fs.closeFile());
+    uEspConfigLib config(&fs);
+    config.addOption("a", "A", "default");
+    config.addOption("b", "B", "");
+    CHECK(!config.loadConfigFile());
+    CHECK_STR(config.getPointer("a"), "default");
+    CHECK_STR(config.getPointer("b"), "2");
+    CHECK(config.getMetrics().loadErrors == 1);
+
+    CHECK(config.beginLoad());
+    int8_t result;
+    while ((result = config.stepLoad(1)) == 0) {
+    }
+    CHECK(result == -1);
+    CHECK(!config.isLoaded());
+
+    CHECK(config.beginImport());
+    CHECK(config.importChunk(text.c_str(), text.size()));
+    CHECK(!config.endImport());
+    uEspConfigLibWebRequestMock request;
+    request.setArg("format", "json");
+    config.handleConfigImport(&request);
+    CHECK(request.body == "{\"data\":{\"result\": 0}}");
+}
+
+static void testReset() {
+    uEspConfigLibParser parser;
+    const char * text = "a = partial";
+    for (; *text != 0; text++) {
+        parser.feed(*text);
+    }
+    parser.reset();
+    CHECK(!parser.finish());
+}
+
+int main() {
+    RUN(testBasicSyntax);
+    RUN(testComments);
+    RUN(testValues);
+    RUN(testInvalidLines);
+    RUN(testLongEntriesAreNotTruncated);
+    RUN(testOverlongLinesDiscarded);
+    RUN(testLineStorageRead);
+    RUN(testOverlongLinesReported);
+    RUN(testReset);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Save rate limit: token bucket shared by web handlers and loop(), rejecting or deferring saves
+// Test clock advances one millisecond on each millis() call.
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    return config;
+}
+
+static void testSaveRateLimit() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveRateLimit(1, 1000000, uEspConfigLib_RATE_REJECT);
+    uEspConfigLibWebRequestMock first;
+    first.setArg("ssid", "one");
+    config->handleSaveConfig(&first);
+    CHECK(first.code == 302);
+
+    uEspConfigLibWebRequestMock rejected;
+    rejected.setArg("ssid", "two");
+    config->handleSaveConfig(&rejected);
+    CHECK(rejected.code == 429);
+    CHECK(rejected.body == "Too many requests");
+    CHECK_STR(config->getPointer("ssid"), "one");
+
+    config->setSaveRateLimit(1, 1000000); // Deferred policy
+    uEspConfigLibWebRequestMock allowed;
+    allowed.setArg("ssid", "two");
+    config->handleSaveConfig(&allowed);
+    uEspConfigLibWebRequestMock deferred;
+    deferred.setArg("ssid", "three");
+    deferred.setArg("format", "json");
+    config->handleSaveConfig(&deferred);
+    CHECK(deferred.body == "{\"data\":{\"result\": 1, \"deferred\": 1}}");
+    CHECK_STR(config->getPointer("ssid"), "three");
+    CHECK(strstr(fs.data(), "ssid = two\n") != 0);
+    CHECK(config->isDirty());
+}
+
+static void testDeferredSavedFromLoop() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveRateLimit(1, 50);
+    for (uint8_t i = 0; i < 5; i++) { // Burst: first one saved, the rest joined in one later save
+        uEspConfigLibWebRequestMock request;
+        request.setArg("ssid", String((int) i).c_str());
+        config->handleSaveConfig(&request);
+        CHECK(request.location == (i == 0 ? "/?saved=1" : "/?saved=1&deferred=1"));
+    }
+    CHECK(strstr(fs.data(), "ssid = 0\n") != 0);
+    unsigned int calls = 0;
+    while (config->isDirty()) {
+        config->loop();
+        calls++;
+        CHECK(calls < 1000);
+    }
+    CHECK(calls > 5); // Waited for a token
+    CHECK(strstr(fs.data(), "ssid = 4\n") != 0);
+    CHECK(config->getMetrics().saves == 2);
+    CHECK(config->saveConfigFile()); // Not limited
+}
+
+int main() {
+    RUN(testSaveRateLimit);
+    RUN(testDeferredSavedFromLoop);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Save flags: only non-default values stored with a schema hash, and compact files without comments
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+
+static void addOptions(uEspConfigLib * config) {
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    config->addOption("url", "Server URL", "http://x/?k=v");
+}
+
+static void testNonDefaultOnly() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib saved(&fs);
+    addOptions(&saved);
+    saved.setSaveFlags(uEspConfigLib_SAVE_NONDEFAULT_ONLY);
+    saved.set("ssid", "home");
+    CHECK(saved.saveConfigFile());
+    CHECK(strstr(fs.data(), "ssid = home\n") != 0);
+    CHECK(strstr(fs.data(), "pass =") == 0);
+    CHECK(strstr(fs.data(), "url =") == 0);
+    CHECK(strstr(fs.data(), uEspConfigLib_SCHEMA_HEADER " = ") != 0);
+
+    uEspConfigLib loaded(&fs);
+    addOptions(&loaded);
+    loaded.setSaveFlags(uEspConfigLib_SAVE_NONDEFAULT_ONLY);
+    loaded.set("url", "changed before load"); // Not stored: reset to default
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("ssid"), "home");
+    CHECK_STR(loaded.getPointer("url"), "http://x/?k=v");
+    CHECK(!loaded.isSchemaChanged());
+
+    saved.clear("ssid"); // Back to default: no longer stored
+    CHECK(saved.saveConfigFile());
+    CHECK(strstr(fs.data(), "ssid =") == 0);
+}
+
+static void testSchemaChanged() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib saved(&fs);
+    addOptions(&saved);
+    saved.setSaveFlags(uEspConfigLib_SAVE_NONDEFAULT_ONLY);
+    saved.set("ssid", "home");
+    CHECK(saved.saveConfigFile());
+
+    uEspConfigLib loaded(&fs);
+    loaded.addOption("ssid", "WiFi SSID", "other default");
+    loaded.addOption("pass", "WiFi password", "");
+    loaded.setSaveFlags(uEspConfigLib_SAVE_NONDEFAULT_ONLY);
+    CHECK(loaded.loadConfigFile());
+    CHECK(loaded.isSchemaChanged());
+    CHECK_STR(loaded.getPointer("ssid"), "home");
+}
+
+static void testCompact() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib saved(&fs);
+    addOptions(&saved);
+    saved.setSaveFlags(uEspConfigLib_SAVE_COMPACT);
+    saved.set("pass", "p=a#s s");
+    CHECK(saved.saveConfigFile());
+    CHECK_STR(fs.data(), "ssid=default\npass=p=a#s s\nurl=http://x/?k=v\n");
+
+    saved.setSaveFlags(uEspConfigLib_SAVE_COMPACT | uEspConfigLib_SAVE_NONDEFAULT_ONLY);
+    CHECK(saved.saveConfigFile());
+    CHECK(strncmp(fs.data(), uEspConfigLib_SCHEMA_HEADER "=", strlen(uEspConfigLib_SCHEMA_HEADER) + 1) == 0);
+    CHECK(strstr(fs.data(), "\npass=p=a#s s\n") != 0);
+    CHECK(strchr(fs.data(), '#') == strstr(fs.data(), "#s s")); // No comments
+    CHECK(strstr(fs.data(), "ssid") == 0);
+
+    uEspConfigLib loaded(&fs);
+    addOptions(&loaded);
+    loaded.setSaveFlags(uEspConfigLib_SAVE_COMPACT | uEspConfigLib_SAVE_NONDEFAULT_ONLY);
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("pass"), "p=a#s s");
+    CHECK(!loaded.isSchemaChanged());
+}
+
+int main() {
+    RUN(testNonDefaultOnly);
+    RUN(testSchemaChanged);
+    RUN(testCompact);
+    return 0;
+}
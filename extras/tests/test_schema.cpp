@@ -0,0 +1,64 @@
+// Generated schemas: every name hashed to its own option, options added later still found
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "example_schema.h"
+
+static void testPerfectHash() {
+    for (uint16_t i = 0; i < exampleSchema.count; i++) {
+        CHECK(uEspConfigLibSchema_find(&exampleSchema, exampleSchema_options[i].name) == i);
+    }
+    CHECK(uEspConfigLibSchema_find(&exampleSchema, "missing") == -1);
+    CHECK(uEspConfigLibSchema_find(&exampleSchema, "") == -1);
+    CHECK(uEspConfigLibSchema_find(&exampleSchema, "wifi_ssid2") == -1);
+}
+
+static void testLookup() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib config(&fs);
+    CHECK(config.addSchema(&exampleSchema));
+    CHECK(!config.addSchema(&exampleSchema)); // Only one schema
+    CHECK_STR(config.getPointer("wifi_ssid"), "Unconfigured_device");
+    CHECK_STR(config.getPointer("mqtt_port"), "1883");
+    CHECK_STR(config.getPointer("report_interval"), "60");
+    CHECK(config.getPointer("missing") == 0);
+
+    config.addOption("extra", "Not in schema", "x"); // Found by list scan
+    config.addOption("mqtt_port", "Redefined", "8883"); // Same option, not duplicated
+    CHECK_STR(config.getPointer("extra"), "x");
+    CHECK_STR(config.getPointer("mqtt_port"), "8883");
+    CHECK(config.getPointer("missing") == 0);
+
+    config.set("wifi_ssid", "home");
+    config.set("extra", "y");
+    CHECK(config.saveConfigFile());
+    CHECK(strstr(fs.data(), "wifi_ssid = home\n") != 0);
+
+    uEspConfigLib loaded(&fs);
+    CHECK(loaded.addSchema(&exampleSchema));
+    loaded.addOption("extra", "Not in schema", "x");
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("wifi_ssid"), "home");
+    CHECK_STR(loaded.getPointer("extra"), "y");
+    CHECK_STR(loaded.getPointer("mqtt_port"), "8883");
+}
+
+static void testSection() {
+    uEspConfigLibFSMemory main;
+    uEspConfigLibFSMemory net;
+    uEspConfigLib config(&main);
+    CHECK(!config.addSchema(&exampleSchema, "net")); // Section not defined
+    config.addSection("net", &net);
+    CHECK(config.addSchema(&exampleSchema, "net"));
+    config.set("mqtt_host", "broker");
+    CHECK(config.saveConfigFile());
+    CHECK(strstr(net.data(), "mqtt_host = broker\n") != 0);
+    CHECK(strstr(main.data(), "mqtt_host") == 0);
+}
+
+int main() {
+    RUN(testPerfectHash);
+    RUN(testLookup);
+    RUN(testSection);
+    return 0;
+}
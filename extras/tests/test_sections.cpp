@@ -0,0 +1,92 @@
+// Sections: own storage per section, lazy load on first access and only changed sections saved
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * main, uEspConfigLibFSMemory * net, uEspConfigLibFSMemory * cal) {
+    uEspConfigLib * config = new uEspConfigLib(main);
+    config->addSection("net", net);
+    config->addSection("cal", cal);
+    config->addOption("name", "Device name", "device");
+    config->addOption("net", "ssid", "WiFi SSID", "default", uEspConfigLib_OPTION_NONE);
+    config->addOption("cal", "offset", "Sensor offset", "0", uEspConfigLib_OPTION_NONE);
+    return config;
+}
+
+static void testSeparateFiles() {
+    uEspConfigLibFSMemory main;
+    uEspConfigLibFSMemory net;
+    uEspConfigLibFSMemory cal;
+    uEspConfigLib * config = create(&main, &net, &cal);
+    config->set("name", "kitchen");
+    config->set("ssid", "home");
+    CHECK(config->saveConfigFile());
+    CHECK(strstr(main.data(), "name = kitchen\n") != 0);
+    CHECK(strstr(main.data(), "ssid") == 0);
+    CHECK(strstr(net.data(), "ssid = home\n") != 0);
+    CHECK(strstr(net.data(), "name") == 0);
+    CHECK(cal.length() == 0); // Not changed, not saved
+    CHECK(!config->isDirty());
+
+    size_t netWritten = net.bytesWritten();
+    size_t mainWritten = main.bytesWritten();
+    config->set("offset", "-3");
+    CHECK(config->flush()); // Only changed section is written
+    CHECK(strstr(cal.data(), "offset = -3\n") != 0);
+    CHECK(net.bytesWritten() == netWritten);
+    CHECK(main.bytesWritten() == mainWritten);
+}
+
+static void testLazyLoad() {
+    uEspConfigLibFSMemory main;
+    uEspConfigLibFSMemory net;
+    uEspConfigLibFSMemory cal;
+    uEspConfigLib * saved = create(&main, &net, &cal);
+    saved->set("name", "kitchen");
+    saved->set("ssid", "home");
+    saved->set("offset", "7");
+    CHECK(saved->saveConfigFile());
+
+    uEspConfigLib * config = create(&main, &net, &cal);
+    CHECK(config->loadConfigFile());
+    CHECK(config->getMetrics().loads == 1); // Sections not read yet
+    CHECK_STR(config->getPointer("name"), "kitchen");
+    CHECK_STR(config->getPointer("ssid"), "home");
+    CHECK(config->getMetrics().loads == 2);
+    CHECK_STR(config->getPointer("ssid"), "home");
+    CHECK(config->getMetrics().loads == 2);
+
+    net.clear(); // Reload reads storage again
+    CHECK(!config->loadSection("net"));
+    CHECK(!config->loadSection("none"));
+    CHECK(!config->saveSection("none"));
+
+    // A change on a section not loaded yet keeps the rest of its stored values
+    uEspConfigLib * other = create(&main, &net, &cal);
+    other->addOption("cal", "gain", "Sensor gain", "1", uEspConfigLib_OPTION_NONE);
+    CHECK(other->saveSection("cal"));
+    CHECK(strstr(cal.data(), "offset = 7\n") != 0);
+    CHECK(strstr(cal.data(), "gain = 1\n") != 0);
+}
+
+static void testSectionDownload() {
+    uEspConfigLibFSMemory main;
+    uEspConfigLibFSMemory net;
+    uEspConfigLibFSMemory cal;
+    uEspConfigLib * config = create(&main, &net, &cal);
+    config->set("ssid", "home");
+    uEspConfigLibWebRequestMock request;
+    request.setArg("section", "net");
+    config->handleConfigDownload(&request);
+    CHECK(request.code == 200);
+    CHECK(request.body == net.data());
+    CHECK(request.body.indexOf("ssid = home\n") >= 0);
+}
+
+int main() {
+    RUN(testSeparateFiles);
+    RUN(testLazyLoad);
+    RUN(testSectionDownload);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// A/B slots: newest valid slot loaded, fallback on checksum mismatch, and a failed save never switches slot
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include <string>
+
+static void addOptions(uEspConfigLib * config) {
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    config->addOption("url", "Server URL", "http://x/?k=v");
+}
+
+// Breaks first character of value in whichever slot region holds it, as a torn write would
+static void corrupt(char * regionA, char * regionB, const char * value) {
+    char * position = (char *) memmem(regionA, 1024, value, strlen(value));
+    if (position == 0) {
+        position = (char *) memmem(regionB, 1024, value, strlen(value));
+    }
+    CHECK(position != 0);
+    *position ^= 0x20;
+}
+
+static bool loadSlots(char * regionA, char * regionB, uEspConfigLib ** result) {
+    uEspConfigLibFSMemory * a = new uEspConfigLibFSMemory(regionA, 1024);
+    uEspConfigLibFSMemory * b = new uEspConfigLibFSMemory(regionB, 1024);
+    uEspConfigLib * config = new uEspConfigLib(a);
+    addOptions(config);
+    CHECK(config->setBackupStorage(b));
+    *result = config;
+    return config->loadConfigFile();
+}
+
+static void testSlotFallback() {
+    static char regionA[1024];
+    static char regionB[1024];
+    uEspConfigLib * config;
+    CHECK(!loadSlots(regionA, regionB, &config)); // Both empty
+    config->set("ssid", "first");
+    CHECK(config->saveConfigFile());
+    config->set("ssid", "second");
+    CHECK(config->saveConfigFile());
+    CHECK(strstr(regionA + uEspConfigLibFSMemory_MAGIC_SIZE, uEspConfigLib_SLOT_HEADER " = ") != 0);
+    CHECK(strstr(regionB + uEspConfigLibFSMemory_MAGIC_SIZE, uEspConfigLib_SLOT_HEADER " = ") != 0);
+
+    CHECK(loadSlots(regionA, regionB, &config));
+    CHECK_STR(config->getPointer("ssid"), "second");
+
+    // Newest slot damaged: previous generation is loaded instead
+    corrupt(regionA, regionB, "second");
+    CHECK(loadSlots(regionA, regionB, &config));
+    CHECK_STR(config->getPointer("ssid"), "first");
+
+    // Next save replaces damaged slot, keeping the good one
+    config->set("ssid", "third");
+    CHECK(config->saveConfigFile());
+    CHECK(memmem(regionA, 1024, "first", 5) != 0 || memmem(regionB, 1024, "first", 5) != 0);
+    CHECK(loadSlots(regionA, regionB, &config));
+    CHECK_STR(config->getPointer("ssid"), "third");
+
+    // Both slots damaged: nothing loaded, defaults kept
+    corrupt(regionA, regionB, "third");
+    corrupt(regionA, regionB, "first");
+    CHECK(!loadSlots(regionA, regionB, &config));
+    CHECK_STR(config->getPointer("ssid"), "default");
+}
+
+static void testFailedSaveKeepsSlot() {
+    static char regionA[1024];
+    static char regionB[1024];
+    memset(regionA, 0, sizeof(regionA));
+    memset(regionB, 0, sizeof(regionB));
+    uEspConfigLib * config;
+    loadSlots(regionA, regionB, &config);
+    config->set("ssid", "first");
+    CHECK(config->saveConfigFile());
+    config->set("ssid", "second");
+    CHECK(config->saveConfigFile());
+
+    std::string value(800, 'v'); // Does not fit on slot region: write fails halfway
+    config->set("pass", value.c_str());
+    CHECK(!config->saveConfigFile());
+    CHECK(config->isDirty());
+    CHECK(loadSlots(regionA, regionB, &config));
+    CHECK_STR(config->getPointer("ssid"), "second");
+    CHECK_STR(config->getPointer("pass"), "");
+
+    config->set("ssid", "third"); // Next save goes to the same slot again
+    CHECK(config->saveConfigFile());
+    CHECK(loadSlots(regionA, regionB, &config));
+    CHECK_STR(config->getPointer("ssid"), "third");
+    CHECK(memmem(regionA, 1024, "second", 6) != 0 || memmem(regionB, 1024, "second", 6) != 0);
+}
+
+static void testFailedStepSave() {
+    static char region[300];
+    uEspConfigLibFSMemory fs(region, sizeof(region));
+    uEspConfigLib config(&fs);
+    addOptions(&config);
+    std::string value(400, 'v');
+    config.set("pass", value.c_str());
+    CHECK(config.beginSave());
+    int8_t progress;
+    while ((progress = config.stepSave(64)) >= 0 && progress < 100) {
+    }
+    CHECK(progress == -1);
+    CHECK(config.isDirty());
+    CHECK(!config.saveConfigFile());
+}
+
+int main() {
+    RUN(testSlotFallback);
+    RUN(testFailedSaveKeepsSlot);
+    RUN(testFailedStepSave);
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Static capacity mode: fixed storage limits, and loads that never use heap, reporting lines too long to read
+#include "test.h"
+#include "uEspConfigLibStatic.h"
+#include "uEspConfigLibFSMemory.h"
+#include <string>
+
+static void testLimits() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLibStatic<2, 128> config(&fs);
+    std::string name(uEspConfigLibParser_NAME_SIZE, 'n');
+    CHECK(config.addOption("ssid", "WiFi SSID", "default"));
+    CHECK(!config.addOption("ssid", "Again", ""));
+    CHECK(!config.addOption(name.c_str(), "Name too long to load", ""));
+    CHECK(!config.addOption("pass", "Value too long to load", "", uEspConfigLib_OPTION_NONE, uEspConfigLibParser_VALUE_SIZE + 1));
+    CHECK(!config.addOption("pass", "Does not fit", "", uEspConfigLib_OPTION_NONE, 100));
+    CHECK(config.addOption("pass", "WiFi password", ""));
+    CHECK(!config.addOption("url", "Too many options", ""));
+    CHECK(config.count() == 2);
+
+    std::string value(uEspConfigLibStatic_VALUE_SIZE, 'v');
+    CHECK(!config.set("pass", value.c_str()));
+    value.resize(uEspConfigLibStatic_VALUE_SIZE - 1);
+    CHECK(config.set("pass", value.c_str()));
+    CHECK(config.getPointer("pass") == value);
+    CHECK(config.clear("pass"));
+    CHECK_STR(config.getPointer("pass"), "");
+}
+
+static void testRoundTrip() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLibStatic<4, 512> saved(&fs);
+    saved.addOption("ssid", "WiFi SSID", "default");
+    saved.addOption("pass", "WiFi password", "");
+    saved.set("pass", "p=a#s s");
+    CHECK(saved.saveConfigFile());
+
+    uEspConfigLibStatic<4, 512> loaded(&fs);
+    loaded.addOption("ssid", "WiFi SSID", "other");
+    loaded.addOption("pass", "WiFi password", "");
+    CHECK(loaded.loadConfigFile());
+    CHECK_STR(loaded.getPointer("ssid"), "default");
+    CHECK_STR(loaded.getPointer("pass"), "p=a#s s");
+}
+
+static void testOverlongLinesReported() {
+    uEspConfigLibFSMemory fs;
+    std::string text = "ssid = " + std::string(uEspConfigLibParser_VALUE_SIZE, 'v') + "\n"
+        + std::string(uEspConfigLibParser_NAME_SIZE, 'n') + " = 1\npass = kept\n";
+    CHECK(fs.openToWrite());
+    CHECK(fs.write(text.c_str()));
+    CHECK(fs.closeFile());
+    uEspConfigLibStatic<4, 1024> config(&fs);
+    config.addOption("ssid", "WiFi SSID", "default", uEspConfigLib_OPTION_NONE, uEspConfigLibParser_VALUE_SIZE);
+    config.addOption("pass", "WiFi password", "");
+    CHECK(!config.loadConfigFile()); // Discarded, not truncated nor moved to heap
+    CHECK_STR(config.getPointer("ssid"), "default");
+    CHECK_STR(config.getPointer("pass"), "kept");
+}
+
+static void testWriteError() {
+    static char region[128];
+    uEspConfigLibFSMemory fs(region, sizeof(region));
+    uEspConfigLibStatic<2, 256> config(&fs);
+    config.addOption("ssid", "WiFi SSID", "default");
+    CHECK(!config.saveConfigFile()); // Header and comments do not fit on region
+}
+
+int main() {
+    RUN(testLimits);
+    RUN(testRoundTrip);
+    RUN(testOverlongLinesReported);
+    RUN(testWriteError);
+    return 0;
+}
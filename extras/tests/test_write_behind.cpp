@@ -0,0 +1,89 @@
+// Write-behind saving: bursts of changes saved once from loop(), after quiet period or maximum delay
+// Test clock advances one millisecond on each millis() call.
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    config->addOption("ssid", "WiFi SSID", "default");
+    config->addOption("pass", "WiFi password", "");
+    return config;
+}
+
+static void testQuietPeriod() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveDelay(50);
+    for (uint8_t i = 0; i < 20; i++) { // Burst of changes, each one restarting quiet period
+        uEspConfigLibWebRequestMock request;
+        request.setArg("ssid", String((int) i).c_str());
+        config->handleSaveConfig(&request);
+        CHECK(request.location == "/?saved=1");
+        config->loop();
+    }
+    CHECK(fs.length() == 0);
+    CHECK(config->isDirty());
+    unsigned int calls = 0;
+    while (config->isDirty()) {
+        config->loop();
+        calls++;
+        CHECK(calls < 100);
+    }
+    CHECK(calls > 5);
+    CHECK(config->getMetrics().saves == 1);
+    CHECK(strstr(fs.data(), "ssid = 19\n") != 0);
+    config->loop();
+    CHECK(config->getMetrics().saves == 1); // Nothing pending
+}
+
+static void testMaxDelay() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveDelay(1000000, 200);
+    unsigned int calls = 0;
+    while (fs.length() == 0) { // Changes keep arriving, but waiting is limited
+        config->set("pass", String((int) calls).c_str());
+        config->loop();
+        calls++;
+        CHECK(calls < 1000);
+    }
+    CHECK(calls > 10);
+    CHECK(config->getMetrics().saves == 1);
+}
+
+static void testFlush() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    config->setSaveDelay(1000000);
+    CHECK(config->flush()); // Nothing to save
+    CHECK(fs.length() == 0);
+    config->set("ssid", "now");
+    config->loop();
+    CHECK(fs.length() == 0);
+    CHECK(config->flush());
+    CHECK(!config->isDirty());
+    CHECK(strstr(fs.data(), "ssid = now\n") != 0);
+}
+
+static void testImmediateModeUnchanged() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    uEspConfigLibWebRequestMock request;
+    request.setArg("ssid", "posted");
+    config->handleSaveConfig(&request); // Saved before responding
+    CHECK(strstr(fs.data(), "ssid = posted\n") != 0);
+    config->set("pass", "pending");
+    config->loop(); // set() alone is not saved without write-behind mode
+    CHECK(config->isDirty());
+    CHECK(strstr(fs.data(), "pending") == 0);
+}
+
+int main() {
+    RUN(testQuietPeriod);
+    RUN(testMaxDelay);
+    RUN(testFlush);
+    RUN(testImmediateModeUnchanged);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Yield budget: yield() called once per budget of bytes or time, not after every small write
+// Test clock (micros()) only advances when stub_micros is changed.
+#include "test.h"
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSMemory.h"
+#include "uEspConfigLibWebRequestMock.h"
+#include "uEspConfigLibYield.h"
+
+static uEspConfigLib * create(uEspConfigLibFSMemory * fs) {
+    uEspConfigLib * config = new uEspConfigLib(fs);
+    char name[8];
+    for (uint8_t i = 0; i < 100; i++) {
+        snprintf(name, sizeof(name), "opt%u", i);
+        config->addOption(strdup(name), "Some option description", "Some default value");
+    }
+    return config;
+}
+
+static void testBudget() {
+    uEspConfigLibYield::setBudget(100, 1000);
+    uEspConfigLibYield::step(100); // Starts a new budget
+    unsigned long yields = stub_yields;
+    uEspConfigLibYield::step(60);
+    CHECK(stub_yields == yields);
+    uEspConfigLibYield::step(40); // Bytes used
+    CHECK(stub_yields == yields + 1);
+    uEspConfigLibYield::step(99);
+    CHECK(stub_yields == yields + 1);
+    stub_micros += 1000; // Time used
+    uEspConfigLibYield::step(0);
+    CHECK(stub_yields == yields + 2);
+
+    uEspConfigLibYield::setBudget(0, 1000); // Every step
+    uEspConfigLibYield::step(1);
+    uEspConfigLibYield::step(1);
+    CHECK(stub_yields == yields + 4);
+    uEspConfigLibYield::setBudget(uEspConfigLibYield_BYTES, uEspConfigLibYield_MICROS);
+}
+
+static void testSaveAndRender() {
+    uEspConfigLibFSMemory fs;
+    uEspConfigLib * config = create(&fs);
+    unsigned long yields = stub_yields;
+    CHECK(config->saveConfigFile());
+    unsigned long expected = fs.length() / uEspConfigLibYield_BYTES;
+    CHECK(expected > 5);
+    CHECK(stub_yields - yields >= expected - 1);
+    CHECK(stub_yields - yields <= expected + 4); // Plus open and close
+    CHECK(stub_yields - yields < 100); // Not once per option
+
+    uEspConfigLibWebRequestMock request; // Same page, to know its length
+    config->handleConfigRequestHtml(&request);
+    uEspConfigLib_WebServer server; // Adapter reports bytes sent
+    yields = stub_yields;
+    config->handleConfigRequestHtml(&server);
+    expected = request.body.length() / uEspConfigLibYield_BYTES;
+    CHECK(expected > 5);
+    CHECK(stub_yields - yields >= expected - 1);
+    CHECK(stub_yields - yields <= expected + 4); // Plus response start
+}
+
+int main() {
+    RUN(testBudget);
+    RUN(testSaveAndRender);
+    return 0;
+}
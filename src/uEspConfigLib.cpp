@@ -26,6 +26,102 @@
 #else
     #include "ESP8266WebServer.h"
 #endif
+#ifdef ARDUINO_ARCH_ESP32
+    #include <freertos/FreeRTOS.h>
+    #include <freertos/semphr.h>
+    #define uEspConfigLib_atomicLoad(var) __atomic_load_n(&(var), __ATOMIC_SEQ_CST)
+    #define uEspConfigLib_atomicExchange(var, value) __atomic_exchange_n(&(var), value, __ATOMIC_SEQ_CST)
+    #define uEspConfigLib_atomicAdd(var, value) __atomic_add_fetch(&(var), value, __ATOMIC_SEQ_CST)
+    #define uEspConfigLib_atomicSub(var, value) __atomic_sub_fetch(&(var), value, __ATOMIC_SEQ_CST)
+#else
+    // Single core, no tasks: plain access is enough
+    #define uEspConfigLib_atomicLoad(var) (var)
+    #define uEspConfigLib_atomicExchange(var, value) uEspConfigLib_exchange(&(var), value)
+    #define uEspConfigLib_atomicAdd(var, value) ((var) += (value))
+    #define uEspConfigLib_atomicSub(var, value) ((var) -= (value))
+    static char * uEspConfigLib_exchange(char ** var, char * value) {
+        char * old = *var;
+        *var = value;
+        return old;
+    }
+#endif
+
+#define uEspConfigLib_isBlank(c) (c == ' ' || c == '\t' || c == '\v' || c == '\f')
+
+static uint32_t uEspConfigLib_crc32(uint32_t crc, const char * data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint8_t) data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return crc;
+}
+
+// Checksum of a name/value pair as parser reads it back: value trimmed
+static uint32_t uEspConfigLib_crc32Pair(uint32_t crc, const char * name, const char * value) {
+    size_t len;
+    crc = uEspConfigLib_crc32(crc, name, strlen(name));
+    crc = uEspConfigLib_crc32(crc, "=", 1);
+    while (uEspConfigLib_isBlank(*value)) {
+        value++;
+    }
+    len = strlen(value);
+    while (len > 0 && uEspConfigLib_isBlank(value[len - 1])) {
+        len--;
+    }
+    crc = uEspConfigLib_crc32(crc, value, len);
+    return uEspConfigLib_crc32(crc, "\n", 1);
+}
+
+// Escapes a text to be used inside a JSON string
+static String uEspConfigLib_jsonEscape(const char * text) {
+    String escaped;
+    char code[7];
+    escaped.reserve(strlen(text));
+    for (; *text != 0; text++) {
+        switch (*text) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if ((uint8_t) *text < 0x20) {
+                    snprintf(code, sizeof(code), "\\u%04x", (uint8_t) *text);
+                    escaped += code;
+                } else {
+                    escaped += *text;
+                }
+        }
+    }
+    return escaped;
+}
+
+#define uEspConfigLib_heapString(value) ((value) != 0 ? strlen(value) + 1 : 0)
+
+static void uEspConfigLib_u64toa(char * buffer, uint64_t value) {
+    char digits[21];
+    uint8_t len = 0;
+    do {
+        digits[len++] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (len > 0) {
+        *buffer++ = digits[--len];
+    }
+    *buffer = 0;
+}
 
 
 /**
@@ -38,6 +134,19 @@ uEspConfigLib::uEspConfigLib(uEspConfigLibFSInterface * fs) {
     list = 0;
 }
 
+/**
+ * \brief Constructor, using a key/value storage
+ *
+ * Each option is stored as an independent record, so changing one option writes only that record.
+ *
+ * @param kv Selected uEspConfigLibKVInterface to be used
+ */
+uEspConfigLib::uEspConfigLib(uEspConfigLibKVInterface * kv) {
+    _fs = 0;
+    _kv = kv;
+    list = 0;
+}
+
 void uEspConfigLib::_copyName(uEspConfigLibList * slot, const char * value) {
     uEspConfigLib_free(slot->name);
     slot->name = uEspConfigLib_malloc(value);
@@ -51,15 +160,102 @@ void uEspConfigLib::_copyDefault(uEspConfigLibList * slot, const char * value) {
 }
 
 void uEspConfigLib::_copyValue(uEspConfigLibList * slot, const char * value) {
-    uEspConfigLib_free(slot->value);
-    slot->value = uEspConfigLib_malloc(value);
-    strcpy(slot->value, value);
+    if (!_concurrent) {
+        uEspConfigLib_free(slot->value);
+        slot->value = uEspConfigLib_malloc(value);
+        strcpy(slot->value, value);
+        _version++;
+        return;
+    }
+    // Readers may be copying old value: swap pointer and free old one when no reader is active
+    char * copy = uEspConfigLib_malloc(value);
+    strcpy(copy, value);
+    _lock();
+    char * old = uEspConfigLib_atomicExchange(slot->value, copy);
+    uEspConfigLib_atomicAdd(_version, 1);
+    _retire(old);
+    _unlock();
 }
 
 void uEspConfigLib::_copyValue(uEspConfigLibList * slot, const String value) {
-    uEspConfigLib_free(slot->value);
-    slot->value = (char *) malloc(sizeof(char) * (value.length() + 1));
-    value.toCharArray(slot->value, value.length() + 1);
+    _copyValue(slot, value.c_str());
+}
+
+// Grace period reclamation: readers count themselves in the counter of current epoch parity. Epoch only advances
+// when the counter of the other parity is empty, so a value retired on epoch N has no readers left once epoch is N + 2.
+// Called with lock held, never waits for readers.
+void uEspConfigLib::_retire(char * value) {
+    if (value == 0) {
+        return;
+    }
+    if (_retiredCount >= _retiredSize) {
+        uint16_t size = _retiredSize == 0 ? uEspConfigLib_RETIRED_SIZE : _retiredSize * 2;
+        uEspConfigLibRetired * retired = (uEspConfigLibRetired *) realloc(_retired, sizeof(uEspConfigLibRetired) * size);
+        if (retired == 0) { // Out of memory: leaking it is safer than freeing it under a reader
+            return;
+        }
+        _retired = retired;
+        _retiredSize = size;
+    }
+    _retired[_retiredCount].value = value;
+    _retired[_retiredCount].epoch = _epoch;
+    _retiredCount++;
+    _reclaim();
+}
+
+void uEspConfigLib::_reclaim() {
+    uint16_t kept = 0;
+    for (uint8_t i = 0; i < 2 && uEspConfigLib_atomicLoad(_readers[(_epoch + 1) & 1]) == 0; i++) {
+        uEspConfigLib_atomicAdd(_epoch, 1);
+    }
+    for (uint16_t i = 0; i < _retiredCount; i++) {
+        if (_epoch - _retired[i].epoch >= 2) {
+            free(_retired[i].value);
+        } else {
+            _retired[kept] = _retired[i];
+            kept++;
+        }
+    }
+    _retiredCount = kept;
+}
+
+void uEspConfigLib::_lock() {
+    #ifdef ARDUINO_ARCH_ESP32
+        if (_mutex != 0) {
+            xSemaphoreTakeRecursive((SemaphoreHandle_t) _mutex, portMAX_DELAY);
+        }
+    #endif
+}
+
+void uEspConfigLib::_unlock() {
+    #ifdef ARDUINO_ARCH_ESP32
+        if (_mutex != 0) {
+            xSemaphoreGiveRecursive((SemaphoreHandle_t) _mutex);
+        }
+    #endif
+}
+
+uint8_t uEspConfigLib::_readBegin() {
+    if (!_concurrent) {
+        return 0;
+    }
+    uint8_t parity = uEspConfigLib_atomicLoad(_epoch) & 1;
+    uEspConfigLib_atomicAdd(_readers[parity], 1);
+    return parity;
+}
+
+void uEspConfigLib::_readEnd(const uint8_t parity) {
+    if (_concurrent) {
+        uEspConfigLib_atomicSub(_readers[parity], 1);
+    }
+}
+
+// Copies current value, so it can be sent without keeping a read section open during network writes
+String uEspConfigLib::_readValue(uEspConfigLibList * slot) {
+    uint8_t parity = _readBegin();
+    String value = uEspConfigLib_atomicLoad(slot->value);
+    _readEnd(parity);
+    return value;
 }
 
 void uEspConfigLib::_copyDescription(uEspConfigLibList * slot, const char * value) {
@@ -79,36 +275,142 @@ void uEspConfigLib::_copyDescription(uEspConfigLibList * slot, const char * valu
  * @param option Optional. Lets you specify extra features of this configuration option. i.e.: uEspConfigLib_OPTION_SCANNER for SSID scanner
  */
 void uEspConfigLib::addOption(const char * name, const char * description, const char * defaultValue, const uint8_t option) {
-    if (list == 0) {
-        list = new uEspConfigLibList;
-        _copyName(list, name);
-        _copyDescription(list, description);
-        _copyDefault(list, defaultValue);
-        _copyValue(list, defaultValue);        
-        list->option = option;
-        list->next = 0;
-        return;
+    _addOption(0, name, description, defaultValue, option);
+}
+
+/**
+ * \brief Defines a configuration option inside a section
+ *
+ * Section options are stored in section's own storage, loaded on first access and saved only when changed.
+ * Option names must be unique among all sections.
+ *
+ * @param section Name of the section, see addSection
+ * @param name Name of configuration option
+ * @param description Description of the configuration option
+ * @param defaultValue Default value of the configuration option
+ * @param option Lets you specify extra features of this configuration option. i.e.: uEspConfigLib_OPTION_SCANNER for SSID scanner
+ */
+void uEspConfigLib::addOption(const char * section, const char * name, const char * description, const char * defaultValue, const uint8_t option) {
+    _addOption(_getSection(section, true), name, description, defaultValue, option);
+}
+
+uEspConfigLibList * uEspConfigLib::_addOption(uEspConfigLibSection * section, const char * name, const char * description, const char * defaultValue, const uint8_t option) {
+    uEspConfigLibList * slot = _findSlot(name);
+    if (slot == 0) {
+        slot = new uEspConfigLibList;
+        _copyName(slot, name);
+        _options++;
+        if (list == 0) {
+            list = slot;
+        } else {
+            uEspConfigLibList * prev = list;
+            while (prev->next != 0) {
+                prev = prev->next;
+            }
+            prev->next = slot;
+        }
+    }
+    _copyDescription(slot, description);
+    _copyDefault(slot, defaultValue);
+    _copyValue(slot, defaultValue);
+    slot->option = option;
+    slot->section = section;
+    return slot;
+}
+
+/**
+ * \brief Defines all options of a generated schema
+ *
+ * Schemas are generated from a schema file by extras/schema_generator/uEspConfigLib_schema.py. Option names found
+ * in the schema are then looked up with one hash and one compare. Only one schema can be added.
+ *
+ * @param schema Generated schema
+ * @param section Optional. Name of the section for all schema options, see addSection
+ * @return False on error (schema already added or section not defined)
+ */
+bool uEspConfigLib::addSchema(const uEspConfigLibSchema * schema, const char * sectionName) {
+    uEspConfigLibSection * section = 0;
+    if (_schema != 0) {
+        return false;
+    }
+    if (sectionName != 0) {
+        section = _getSection(sectionName, false);
+        if (section == 0) {
+            return false;
+        }
+    }
+    _schemaSlots = new uEspConfigLibList *[schema->count];
+    for (uint16_t i = 0; i < schema->count; i++) {
+        const uEspConfigLibSchemaOption * option = &schema->options[i];
+        _schemaSlots[i] = _addOption(section, option->name, option->description, option->defaultValue, option->option);
+        uEspConfigLibYield::step(strlen(option->name) + strlen(option->description) + strlen(option->defaultValue));
+    }
+    _schema = schema;
+    return true;
+}
+
+/**
+ * \brief Defines a section, a group of options stored on its own storage
+ *
+ * @param name Name of the section
+ * @param fs Selected uEspConfigLibFSInterface to be used for this section (i.e.: another file path)
+ */
+void uEspConfigLib::addSection(const char * name, uEspConfigLibFSInterface * fs) {
+    uEspConfigLibSection * section = _getSection(name, true);
+    section->fs = fs;
+    section->loaded = false;
+}
+
+uEspConfigLibSection * uEspConfigLib::_getSection(const char * name, const bool create) {
+    uEspConfigLibSection * section;
+    for (section = _sections; section != 0; section = section->next) {
+        if (strcmp(section->name, name) == 0) {
+            return section;
+        }
+    }
+    if (!create) {
+        return 0;
+    }
+    section = new uEspConfigLibSection;
+    section->name = uEspConfigLib_malloc(name);
+    strcpy(section->name, name);
+    section->next = _sections;
+    _sections = section;
+    return section;
+}
+
+uEspConfigLibList * uEspConfigLib::_findSlot(const char * name) {
+    if (_schema != 0) {
+        int index = uEspConfigLibSchema_find(_schema, name);
+        if (index >= 0) {
+            return _schemaSlots[index];
+        }
+        if (_options == _schema->count) { // Every option is in schema
+            return 0;
+        }
     }
-    
-    uEspConfigLibList * prev = list;
     for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
         if (strcmp(slot->name, name) == 0) {
-            _copyDescription(slot, description);
-            _copyDefault(slot, defaultValue);
-            _copyValue(slot, defaultValue);        
-            list->option = option;
-            return;
+            return slot;
         }
-        prev = slot;
     }
-    
-    prev->next = new uEspConfigLibList;
-    _copyName(prev->next, name);
-    _copyDescription(prev->next, description);
-    _copyDefault(prev->next, defaultValue);
-    _copyValue(prev->next, defaultValue);        
-    prev->next->option = option;
-    prev->next->next = 0;
+    return 0;
+}
+
+void uEspConfigLib::_ensureAllLoaded() {
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        _ensureLoaded(slot);
+    }
+}
+
+void uEspConfigLib::_ensureLoaded(uEspConfigLibList * slot) {
+    if (slot->section != 0 && !slot->section->loaded) {
+        _lock();
+        if (!slot->section->loaded) {
+            _loadSection(slot->section);
+        }
+        _unlock();
+    }
 }
 
 
@@ -120,17 +422,14 @@ void uEspConfigLib::addOption(const char * name, const char * description, const
  * @return False on error (name not defined previously)
  */
 bool uEspConfigLib::set(const char * name, const char *value) {
-    if (list == 0) {
+    uEspConfigLibList * slot = _findSlot(name);
+    if (slot == 0) {
         return false;
     }
-    
-    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
-        if (strcmp(slot->name, name) == 0) {
-            _copyValue(slot, value);
-            return true;
-        }
-    }
-    return false;
+    _ensureLoaded(slot);
+    _copyValue(slot, value);
+    _markDirty(slot);
+    return true;
 }
 
 /**
@@ -140,12 +439,63 @@ bool uEspConfigLib::set(const char * name, const char *value) {
  * @return Char pointer. Null if not found.
  */
 char * uEspConfigLib::getPointer(const char * name) {
-    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
-        if (strcmp(slot->name, name) == 0) {
-            return slot->value;
-        }
+    uEspConfigLibList * slot = _findSlot(name);
+    if (slot == 0) {
+        return 0;
     }
-    return 0;
+    _ensureLoaded(slot);
+    return slot->value;
+}
+
+/**
+ * \brief Copies current value of a configuration option, safe to be used from any task in concurrent mode
+ *
+ * @param name Name of configuration option
+ * @param buffer Buffer where value will be copied
+ * @param size Buffer size, including string terminator. Longer values are truncated
+ * @return False on error (name not defined previously)
+ */
+bool uEspConfigLib::get(const char * name, char * buffer, const size_t size) {
+    uEspConfigLibList * slot = _findSlot(name);
+    if (slot == 0 || size == 0) {
+        return false;
+    }
+    _ensureLoaded(slot);
+    uint8_t parity = _readBegin();
+    const char * value = uEspConfigLib_atomicLoad(slot->value);
+    strncpy(buffer, value, size - 1);
+    _readEnd(parity);
+    buffer[size - 1] = 0;
+    return true;
+}
+
+/**
+ * \brief Gets configuration version, incremented on each value change
+ *
+ * Lets tasks detect changes without copying values.
+ *
+ * @return Current version
+ */
+uint32_t uEspConfigLib::version() {
+    return uEspConfigLib_atomicLoad(_version);
+}
+
+/**
+ * \brief Enables or disables concurrent mode, for ESP32 tasks reading configuration while it is changed
+ *
+ * In concurrent mode values are replaced atomically and old ones are freed only when no reader is copying them,
+ * so get() is safe from any task without blocking. Pointers from getPointer() are only valid until option changes.
+ * Enable it at setup, before starting tasks that use the configuration. Defining options is not thread-safe.
+ *
+ * @param enabled True to enable
+ */
+void uEspConfigLib::setConcurrentMode(const bool enabled) {
+    #ifdef ARDUINO_ARCH_ESP32
+        if (enabled && _mutex == 0) {
+            _mutex = (void *) xSemaphoreCreateRecursiveMutex();
+        }
+    #endif
+    _concurrent = enabled;
 }
 
 /**
@@ -155,14 +505,14 @@ char * uEspConfigLib::getPointer(const char * name) {
  * @return False on error (name not defined previously)
  */
 bool uEspConfigLib::clear(const char *name) {
-    uEspConfigLibList *slot;
-    for (slot = list; slot != 0; slot = slot->next) {
-        if (strcmp(slot->name, name) == 0) {
-            _copyValue(slot, slot->defaultValue);
-            return true;
-        }
+    uEspConfigLibList * slot = _findSlot(name);
+    if (slot == 0) {
+        return false;
     }
-    return false;
+    _ensureLoaded(slot);
+    _copyValue(slot, slot->defaultValue);
+    _markDirty(slot);
+    return true;
 }
 
 /**
@@ -174,62 +524,56 @@ bool uEspConfigLib::clear(const char *name) {
  * @param path Path where the form will be sent
  */
 void uEspConfigLib::handleConfigRequestHtml(uEspConfigLib_WebServer * server, const char *path) {
-    if(server->arg("option") == "scan" && server->arg("field").length() > 0) {
-        _handleWifiScan(server, server->arg("field"));
+    uEspConfigLibWebServerRequest request(server);
+    handleConfigRequestHtml(&request, path);
+}
+
+/**
+ * \brief Handles a configuration HTML form request, on any web server
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ * @param path Path where the form will be sent
+ */
+void uEspConfigLib::handleConfigRequestHtml(uEspConfigLibWebRequest * request, const char *path) {
+    unsigned long start = uEspConfigLib_micros();
+    if(request->arg("option") == "scan" && request->arg("field").length() > 0) {
+        _handleWifiScan(request, request->arg("field"));
+        _countRequest(request, start);
         return;
     }
 
-    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
-    yield();
-    server->send(200, "text/html", "");
-    yield();
-    server->sendContent("<html><head><title>IoT device config - uConfigLib</title></head><body><form method=\"POST\" action=\"");
-    yield();
-    server->sendContent(path);
-    yield();
-    server->sendContent("\"><table border=\"0\">");
-    yield();
+    request->begin(200, "text/html");
+    request->sendContent("<html><head><title>IoT device config - uConfigLib</title></head><body><form method=\"POST\" action=\"");
+    request->sendContent(path);
+    request->sendContent("\"><table border=\"0\">");
     uEspConfigLibList *slot;
+    _ensureAllLoaded();
     for (slot = list; slot != 0; slot = slot->next) {
-        server->sendContent("<tr><td colspan=\"2\"><br>");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->description);
-        yield();
-        server->sendContent(":</td></tr><tr><td>");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->name);
-        yield();
-        server->sendContent(" (default: ");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->defaultValue);
-        yield();
-        server->sendContent("):</td><td><input type=\"text\" name=\"");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->name);
-        yield();
+        request->sendContent("<tr><td colspan=\"2\"><br>");
+        request->sendContent(slot->description);
+        request->sendContent(":</td></tr><tr><td>");
+        request->sendContent(slot->name);
+        request->sendContent(" (default: ");
+        request->sendContent(slot->defaultValue);
+        request->sendContent("):</td><td><input type=\"text\" name=\"");
+        request->sendContent(slot->name);
         if (slot->option == uEspConfigLib_OPTION_SCANNER) {
-            server->sendContent("\" id=\"");
-            yield();
-            uEspConfigLib_WebServer_sendContent(slot->name);
-            yield();
-        }
-        server->sendContent("\" value=\"");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->value);
-        yield();
-        server->sendContent("\">");
-        yield();
+            request->sendContent("\" id=\"");
+            request->sendContent(slot->name);
+        }
+        request->sendContent("\" value=\"");
+        request->sendContent(_readValue(slot));
+        request->sendContent("\">");
         if (slot->option == uEspConfigLib_OPTION_SCANNER) {
-            server->sendContent(" <a href=\"javascript:window.open('?option=scan&field=");
-            uEspConfigLib_WebServer_sendContent(slot->name);
-            server->sendContent("')\">Scan</a>");
-            yield();
+            request->sendContent(" <a href=\"javascript:window.open('?option=scan&field=");
+            request->sendContent(slot->name);
+            request->sendContent("')\">Scan</a>");
         }        
-        server->sendContent("</td></tr>");
-        yield();
+        request->sendContent("</td></tr>");
     }
-    server->sendContent("<tr><td colspan=\"2\"><br><center><button type=\"submit\">Send</button></center></td></tr></table></body>");
-    yield();
+    request->sendContent("<tr><td colspan=\"2\"><br><center><button type=\"submit\">Send</button></center></td></tr></table></body>");
+    request->end();
+    _countRequest(request, start);
 }
 
 /**
@@ -263,40 +607,40 @@ void uEspConfigLib::handleConfigRequestHtml(uEspConfigLib_WebServer * server, co
  * @param server WebServer or ESP8266WebServer variable, depending on architecture
  */
 void uEspConfigLib::handleConfigRequestJson(uEspConfigLib_WebServer * server) {
-    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
-    yield();
-	server->send(200, "application/vnd.api+json", "");
-    yield();
-    server->sendContent("{\"data\":[");
-    yield();
+    uEspConfigLibWebServerRequest request(server);
+    handleConfigRequestJson(&request);
+}
+
+/**
+ * \brief Handles a configuration JSON request, on any web server
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ */
+void uEspConfigLib::handleConfigRequestJson(uEspConfigLibWebRequest * request) {
+    unsigned long start = uEspConfigLib_micros();
+	request->begin(200, "application/vnd.api+json");
+    request->sendContent("{\"data\":[");
     bool first = true;
+    _ensureAllLoaded();
     for (uEspConfigLibList *slot = list; slot != 0; slot = slot->next) {
         if (first) {
             first = false;
         } else {
-            server->sendContent(",");
-            yield();
+            request->sendContent(",");
         }
-        server->sendContent("{\"name\":\"");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->name);
-        yield();
-        server->sendContent("\", \"description\":\"");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->description);
-        yield();
-        server->sendContent("\", \"defaultValue\":\"");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->defaultValue);
-        yield();
-        server->sendContent("\", \"value\":\"");
-        yield();
-        uEspConfigLib_WebServer_sendContent(slot->value);
-        yield();
-        server->sendContent("\"}");
-        yield();
+        request->sendContent("{\"name\":\"");
+        request->sendContent(uEspConfigLib_jsonEscape(slot->name));
+        request->sendContent("\", \"description\":\"");
+        request->sendContent(uEspConfigLib_jsonEscape(slot->description));
+        request->sendContent("\", \"defaultValue\":\"");
+        request->sendContent(uEspConfigLib_jsonEscape(slot->defaultValue));
+        request->sendContent("\", \"value\":\"");
+        request->sendContent(uEspConfigLib_jsonEscape(_readValue(slot).c_str()));
+        request->sendContent("\"}");
     }
-    server->sendContent("]}");
+    request->sendContent("]}");
+    request->end();
+    _countRequest(request, start);
 }
 
 
@@ -304,6 +648,7 @@ void uEspConfigLib::handleConfigRequestJson(uEspConfigLib_WebServer * server) {
  * \brief Handles a save configuration request
  *
  * This will handle the request and parameters, change any existing one and save the config file.
+ * In write-behind mode (see setSaveDelay) the config file is saved later from loop() instead.
  * If a config option is not set as parameter will be ignored. If a config option is empty it will be stored as empty.
  * It usually will respond with a 302 redirect to /?saved=1, but if "format" paramer is passed with "json" value it will respond as JSON:
  *  {
@@ -312,170 +657,1758 @@ void uEspConfigLib::handleConfigRequestJson(uEspConfigLib_WebServer * server) {
  *     }
  * }
  *
+ * When save rate limit is reached (see setSaveRateLimit), or an incremental save or load is in progress, saving is deferred to loop(), adding "deferred": 1 to JSON response
+ * and &deferred=1 to redirect, or request is rejected with 429 status.
+ *
  * @param server WebServer or ESP8266WebServer variable, depending on architecture
  */
 void uEspConfigLib::handleSaveConfig(uEspConfigLib_WebServer * server) {
+    uEspConfigLibWebServerRequest request(server);
+    handleSaveConfig(&request);
+}
+
+/**
+ * \brief Handles a save configuration request, on any web server
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ */
+void uEspConfigLib::handleSaveConfig(uEspConfigLibWebRequest * request) {
     String value;
     bool isJson;
+    unsigned long start = uEspConfigLib_micros();
+
+    bool deferred = false;
 
-    value = server->arg("format");
+    value = request->arg("format");
     isJson = (value == "json");
-    
+
+    if (_saveDelay == 0 && (_loader != 0 || _saving)) { // Saved from loop() once incremental save or load finishes
+        deferred = true;
+    } else if (_saveDelay == 0 && !_takeSaveToken()) {
+        if (_ratePolicy == uEspConfigLib_RATE_REJECT) {
+            request->begin(429, isJson ? "application/vnd.api+json" : "text/plain");
+            request->sendContent(isJson ? "{\"data\":{\"result\": 0}}" : "Too many requests");
+            request->end();
+            _countRequest(request, start);
+            return;
+        }
+        deferred = true;
+    }
+
     for (uEspConfigLibList *slot = list; slot != 0; slot = slot->next) {
-        if (server->hasArg(slot->name)) {
-            value = server->arg(slot->name);
+        if (request->hasArg(slot->name)) {
+            value = request->arg(slot->name);
             value.trim();
+            _ensureLoaded(slot);
             _copyValue(slot, value.c_str());
+            _markDirty(slot);
         }
     }
-    saveConfigFile();
+    if (deferred) { // Saved from loop() when allowed
+        _saveDeferred = true;
+    } else if (_saveDelay == 0) {
+        _saveDirty();
+    }
     
-    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
     if (isJson) {
-        server->send(200, "application/vnd.api+json", "");
-	    server->sendContent("{\"data\":{\"result\": 1}}");
+        request->begin(200, "application/vnd.api+json");
+	    request->sendContent(deferred ? "{\"data\":{\"result\": 1, \"deferred\": 1}}" : "{\"data\":{\"result\": 1}}");
+        request->end();
     } else {
-      server->sendHeader("Location", "/?saved=1", true);
-      server->send(302, "text/html","");
+      request->redirect(deferred ? "/?saved=1&deferred=1" : "/?saved=1");
     }
+    _countRequest(request, start);
+}
+
+
+/**
+ * \brief Handles a configuration download request, streaming stored config file in chunks
+ *
+ * Pending changes are saved first, unless save rate limit is reached (see setSaveRateLimit): then stored file is sent
+ * and changes are saved later from loop(). Use "section" argument to download a section file instead of main one.
+ * Main config file is not available (503 status) while an incremental save or load is in progress.
+ * When using a key/value storage main options are sent in config file syntax.
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
+ */
+void uEspConfigLib::handleConfigDownload(uEspConfigLib_WebServer * server) {
+    uEspConfigLibWebServerRequest request(server);
+    handleConfigDownload(&request);
 }
 
+/**
+ * \brief Handles a configuration download request, on any web server
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ */
+void uEspConfigLib::handleConfigDownload(uEspConfigLibWebRequest * request) {
+    uEspConfigLibFSInterface * fs = 0;
+	char chunk[uEspConfigLib_READ_CHUNK_SIZE];
+    size_t len;
+    unsigned long start = uEspConfigLib_micros();
+
+    if (request->hasArg("section")) {
+        uEspConfigLibSection * section = _getSection(request->arg("section").c_str(), false);
+        if (section == 0 || section->fs == 0) {
+            request->begin(404, "text/plain");
+            request->sendContent("Section not found");
+            request->end();
+            _countRequest(request, start);
+            return;
+        }
+        fs = section->fs;
+    } else if (_kv != 0) {
+        request->begin(200, "text/plain");
+        for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+            if (slot->section == 0) {
+                request->sendContent(slot->name);
+                request->sendContent(" = ");
+                request->sendContent(_readValue(slot));
+                request->sendContent("\n");
+            }
+        }
+        request->end();
+        _countRequest(request, start);
+        return;
+    }
 
-void uEspConfigLib::_parseConfigLine(String line) {
-    int pos;
-    String variable, value;
-    line.trim();
-    if (line.startsWith(";") || line.startsWith("#") || line.startsWith("//")) { // comment line
-	    return;
+    if (fs == 0 && (_saving || _loader != 0)) { // Main storage in use by an incremental save or load
+        request->begin(503, "text/plain");
+        request->sendContent("Config file busy");
+        request->end();
+        _countRequest(request, start);
+        return;
     }
-    pos = line.indexOf('=');
-    if (pos < 2) { // Not found or too short for sure, skip
-	    return;
+    if (uEspConfigLib_atomicLoad(_dirty)) {
+        if (_takeSaveToken()) {
+            _saveDirty();
+        } else { // Rate limited: stored file is sent, changes are saved from loop() when allowed
+            _saveDeferred = true;
+        }
+    }
+    if (!request->hasArg("section")) {
+        fs = _mainFs(); // After saving, as it may change active slot
+    }
+    if (!fs->openToRead()) {
+        request->begin(404, "text/plain");
+        request->sendContent("Config file not available");
+        request->end();
+        _countRequest(request, start);
+        return;
     }
-    variable = line.substring(0, pos - 1);
-    value = line.substring(pos + 1);
-    variable.trim();
-    value.trim();
+    request->begin(200, "text/plain");
+    while ((len = fs->read(chunk, uEspConfigLib_READ_CHUNK_SIZE)) > 0) { // Sent by length, file may have any byte
+        request->sendContent(chunk, len);
+    }
+    fs->closeFile();
+    request->end();
+    _countRequest(request, start);
+}
 
-    set(variable.c_str(), value.c_str());
+/**
+ * \brief Handles a config file upload, receiving it in chunks
+ *
+ * Use it as upload handler: server.on(path, HTTP_POST, handleConfigImport, handleConfigUpload).
+ * Uploaded file is parsed as it arrives, so it is never fully stored in RAM.
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
+ */
+void uEspConfigLib::handleConfigUpload(uEspConfigLib_WebServer * server) {
+    HTTPUpload& upload = server->upload();
+    switch (upload.status) {
+        case UPLOAD_FILE_START:
+            beginImport();
+            break;
+        case UPLOAD_FILE_WRITE:
+            importChunk((const char *) upload.buf, upload.currentSize);
+            break;
+        case UPLOAD_FILE_END:
+            endImport();
+            break;
+        default: // Aborted: keep values already applied, but do not save them now
+            if (_import != 0) {
+                delete _import;
+                _import = 0;
+            }
+            _importResult = false;
+            break;
+    }
 }
 
+/**
+ * \brief Handles the response of a config file upload
+ *
+ * It responds as handleSaveConfig, with result 0 if import failed.
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
+ */
+void uEspConfigLib::handleConfigImport(uEspConfigLib_WebServer * server) {
+    uEspConfigLibWebServerRequest request(server);
+    handleConfigImport(&request);
+}
 
 /**
- * \brief Loads config file from FileSystem and processes it
+ * \brief Handles the response of a config file upload, on any web server
  *
- * @return False on error
+ * Reports the result of last beginImport() and endImport().
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
  */
-bool uEspConfigLib::loadConfigFile() {
-    bool result;
-	String line;
-    result = _fs->openToRead();
-    if (!result) {
-        return false;
-    }
-    while (_fs->readLine(&line)) {
-	    _parseConfigLine(line);
+void uEspConfigLib::handleConfigImport(uEspConfigLibWebRequest * request) {
+    unsigned long start = uEspConfigLib_micros();
+    if (request->arg("format") == "json") {
+        request->begin(200, "application/vnd.api+json");
+        request->sendContent(_importResult ? "{\"data\":{\"result\": 1}}" : "{\"data\":{\"result\": 0}}");
+        request->end();
+    } else {
+        request->redirect(_importResult ? "/?saved=1" : "/?saved=0");
     }
-    _fs->closeFile();
-    return true;
+    _countRequest(request, start);
 }
 
 /**
- * \brief Recreates and overwrites config file to FileSystem with current configurations
+ * \brief Handles a server-sent events (text/event-stream) request, pushing configuration changes
  *
- * @return False on error
+ * Each change done with set(), clear(), handleSaveConfig() or an import sends a "change" event with
+ * {"name":"variable_name","value":"variable_current_value"} data. Changes are queued per client and sent from loop().
+ * If a client queue overflows, or its connection cannot take more data without blocking, pending events are dropped and
+ * it receives a "reload" event instead, meaning it should read all configuration again.
+ * Connection stays open after handler returns, served from loop(); response ends when connection is closed.
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
  */
-bool uEspConfigLib::saveConfigFile() {
-    bool result;
-    
-    result = _fs->openToWrite();
-    if (!result) {
-        return false;
+void uEspConfigLib::handleConfigEvents(uEspConfigLib_WebServer * server) {
+    uEspConfigLibWebServerRequest request(server);
+    handleConfigEvents(&request);
+}
+
+/**
+ * \brief Handles a server-sent events request, on any web server supporting streams
+ *
+ * Responds with 501 status if request adapter does not support streams (see uEspConfigLibWebRequest::openStream).
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ */
+void uEspConfigLib::handleConfigEvents(uEspConfigLibWebRequest * request) {
+    uint8_t i;
+    if (_sse == 0) {
+        _sse = new uEspConfigLibSseClient[uEspConfigLib_SSE_CLIENTS];
     }
-    _fs->write("# uConfigLib Configuration file\n");
-    yield();
-    _fs->write("# Visit https://github.com/Naguissa/uEspConfigLib for details\n");
-    yield();
-    _fs->write("# Syntax:\n");
-    yield();
-	_fs->write("# variable = value\n");
-    yield();
-	_fs->write("# (spaces and empty lines doesn't care)\n");
-    yield();
-	_fs->write("# This file comments: lines starting with #, ; or //\n");
-    yield();
-	
-    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
-        _fs->write("\n# ");
-        yield();
-        _fs->write(slot->name);
-        yield();
-        _fs->write(" -- ");
-        yield();
-        _fs->write(slot->description);
-        yield();
-        _fs->write("\n# Default value: ");
-        yield();
-        _fs->write(slot->defaultValue);
-        yield();
-        _fs->write("\n");
-        yield();
-        _fs->write(slot->name);
-        yield();
-        _fs->write(" = ");
-        yield();
-        _fs->write(slot->value);
-        yield();
-        _fs->write("\n");
-        yield();
-    }
-    _fs->closeFile();
-	yield();
-	return true;
-}
-
-void uEspConfigLib::_handleWifiScan(uEspConfigLib_WebServer * server, const String field) {
-    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
-    yield();
-    server->send(200, "text/html", "");
-    yield();
-    server->sendContent("<html><head><title>IoT device config - uConfigLib</title></head><body><p><b>WiFi networks:</b></p>");
-    yield();
+    _lock();
+    for (i = 0; i < uEspConfigLib_SSE_CLIENTS && _sse[i].stream != 0; i++);
+    _unlock();
+    if (i == uEspConfigLib_SSE_CLIENTS) {
+        request->begin(503, "text/plain");
+        request->sendContent("Too many clients");
+        request->end();
+        return;
+    }
+    uEspConfigLibStream * stream = request->openStream("text/event-stream");
+    if (stream == 0) {
+        request->begin(501, "text/plain");
+        request->sendContent("Streams not supported");
+        request->end();
+        return;
+    }
+    // Free slot is kept: only this handler activates them, and it does not run twice at once
+    _lock();
+    _sse[i].pending = "";
+    _sse[i].overflow = false;
+    _sse[i].count = 0;
+    _sse[i].lastSent = millis();
+    _sse[i].stream = stream;
+    _unlock();
+}
+
+void uEspConfigLib::_sseQueue(uEspConfigLibList * slot) {
+    if (_sse == 0) {
+        return;
+    }
+    _lock();
+    for (uint8_t i = 0; i < uEspConfigLib_SSE_CLIENTS; i++) {
+        uEspConfigLibSseClient * sse = &_sse[i];
+        uint8_t j;
+        if (sse->stream == 0 || sse->overflow) {
+            continue;
+        }
+        for (j = 0; j < sse->count && sse->queue[j] != slot; j++); // Already queued: last value will be sent
+        if (j < sse->count) {
+            continue;
+        }
+        if (sse->count == uEspConfigLib_SSE_QUEUE_SIZE) {
+            sse->overflow = true;
+            sse->count = 0;
+        } else {
+            sse->queue[sse->count] = slot;
+            sse->count++;
+        }
+    }
+    _unlock();
+}
+
+// Sends queued events. Lock is only held to take the queue: values are copied and sent without it. Events are written
+// as far as the connection takes them, keeping the rest for next calls; those that do not fit on client buffer either
+// are dropped, turned into a "reload" event, instead of blocking loop()
+void uEspConfigLib::_ssePump() {
+    for (uint8_t i = 0; i < uEspConfigLib_SSE_CLIENTS; i++) {
+        uEspConfigLibSseClient * sse = &_sse[i];
+        uEspConfigLibList * queue[uEspConfigLib_SSE_QUEUE_SIZE];
+        uint8_t count;
+        bool overflow;
+        bool sent = true;
+        _lock();
+        if (sse->stream == 0) {
+            _unlock();
+            continue;
+        }
+        overflow = sse->overflow;
+        count = sse->count;
+        memcpy(queue, sse->queue, sizeof(queue[0]) * count);
+        sse->overflow = false;
+        sse->count = 0;
+        _unlock();
+        // Active client is only used here, no lock needed for its connection
+        if (!sse->stream->connected()) {
+            uEspConfigLibStream * stream = sse->stream;
+            _lock();
+            sse->stream = 0;
+            _unlock();
+            delete stream;
+            sse->pending = "";
+            continue;
+        }
+        _sseFlush(sse); // Older events first
+        if (overflow) {
+            sent = _sseSend(sse, "event: reload\ndata: {}\n\n");
+        } else {
+            for (uint8_t j = 0; j < count && sent; j++) {
+                String event = "event: change\ndata: {\"name\":\"";
+                event += uEspConfigLib_jsonEscape(queue[j]->name);
+                event += "\",\"value\":\"";
+                event += uEspConfigLib_jsonEscape(_readValue(queue[j]).c_str());
+                event += "\"}\n\n";
+                sent = _sseSend(sse, event);
+                uEspConfigLibYield::step(event.length());
+            }
+        }
+        if (!sent) { // Client is not reading: it has to reload all configuration when it does
+            _lock();
+            sse->overflow = true;
+            sse->count = 0;
+            _unlock();
+        } else if (sse->pending.length() == 0 && millis() - sse->lastSent >= uEspConfigLib_SSE_KEEPALIVE) {
+            _sseSend(sse, ": keep-alive\n\n");
+        }
+        _sseFlush(sse);
+    }
+}
+
+// Queues an event for the client, false if it does not fit on its buffer. A longer event is only kept alone.
+bool uEspConfigLib::_sseSend(uEspConfigLibSseClient * sse, const String data) {
+    if (sse->pending.length() > 0 && sse->pending.length() + data.length() > uEspConfigLib_SSE_BUFFER_SIZE) {
+        return false;
+    }
+    sse->pending += data;
+    return true;
+}
+
+// Writes queued events as far as connection takes them without blocking
+void uEspConfigLib::_sseFlush(uEspConfigLibSseClient * sse) {
+    if (sse->pending.length() == 0) {
+        return;
+    }
+    size_t written = sse->stream->write(sse->pending.c_str(), sse->pending.length());
+    if (written > 0) {
+        sse->pending.remove(0, written);
+        sse->lastSent = millis();
+    }
+}
+
+/**
+ * \brief Starts importing a config file received in chunks
+ *
+ * @return False on error (import already in progress or out of memory)
+ */
+bool uEspConfigLib::beginImport() {
+    if (_import != 0) {
+        return false;
+    }
+    _import = new uEspConfigLibParser();
+    _importResult = (_import != 0);
+    return _importResult;
+}
+
+/**
+ * \brief Processes a chunk of an imported config file
+ *
+ * Known options are changed as soon as they are parsed; unknown ones are ignored.
+ *
+ * @param data Chunk data
+ * @param len Chunk length
+ * @return False on error (no import in progress)
+ */
+bool uEspConfigLib::importChunk(const char * data, const size_t len) {
+    if (_import == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (_import->feed(data[i])) {
+            _importParsed();
+        }
+    }
+    uEspConfigLibYield::step(len);
+    return true;
+}
+
+/**
+ * \brief Ends importing a config file and saves changed options
+ *
+ * In write-behind mode (see setSaveDelay), or while an incremental save or load is in progress, changes are saved later from loop() instead.
+ *
+ * @return False on error (i.e.: a line longer than uEspConfigLibParser_MAX_SIZE, or save failed)
+ */
+bool uEspConfigLib::endImport() {
+    if (_import == 0) {
+        _importResult = false;
+        return false;
+    }
+    if (_import->finish()) {
+        _importParsed();
+    }
+    _importResult = !_import->discarded(); // Lines too long to be read are not applied
+    delete _import;
+    _import = 0;
+    if (_saveDelay == 0 && (_loader != 0 || _saving)) { // Saved from loop() once incremental save or load finishes
+        _saveDeferred = true;
+    } else if (_saveDelay == 0) {
+        _importResult = _saveDirty() && _importResult;
+    }
+    return _importResult;
+}
+
+void uEspConfigLib::_importParsed() {
+    uEspConfigLibList * slot = _findSlot(_import->name());
+    if (slot == 0) {
+        return;
+    }
+    _ensureLoaded(slot); // Lazy load later would overwrite imported value
+    _copyValue(slot, _import->value());
+    _markDirty(slot);
+}
+
+
+void uEspConfigLib::_applyParsed(uEspConfigLibParser * parser, uEspConfigLibSection * section) {
+    uEspConfigLibList * slot = _findSlot(parser->name());
+    if (slot != 0 && slot->section == section) { // Options of other sections are ignored
+        _copyValue(slot, parser->value());
+    }
+}
+
+
+/**
+ * \brief Loads config file from FileSystem and processes it
+ *
+ * When using a key/value storage each option is read from its record.
+ * Only options without section are loaded, each section is loaded on first access.
+ * A pending incremental load (see beginLoad) is aborted and done again from the beginning.
+ *
+ * @return False on error (i.e.: a line longer than uEspConfigLibParser_MAX_SIZE), or if an incremental save is in progress
+ */
+bool uEspConfigLib::loadConfigFile() {
+    bool result;
+    if (_saving) { // Storage is in use by an incremental save
+        return false;
+    }
+    if (_loader != 0) {
+        if (_kv == 0) {
+            _fs->discardReadAhead();
+            _fs->closeFile();
+        }
+        delete _loader;
+        _loader = 0;
+    }
+    unsigned long start = uEspConfigLib_micros();
+    if (_profiling) {
+        _timings = uEspConfigLibTimings();
+        if (_fs != 0) {
+            _timings.mount = _fs->mountTime();
+            _timings.formatted = _fs->formatted();
+        }
+    }
+    if (_kv != 0) {
+        result = _loadStore();
+    } else if (_fsB != 0) {
+        result = _loadSlots();
+    } else {
+        result = _loadFile(_fs, 0);
+    }
+    if (_profiling) {
+        _timings.total = uEspConfigLib_micros() - start;
+    }
+    _loaded = result;
+    _metrics.loads++;
+    _metrics.loadMicros += uEspConfigLib_micros() - start;
+    if (!result) {
+        _metrics.loadErrors++;
+    }
+    return result;
+}
+
+/**
+ * \brief Starts an incremental load of config file, to be continued with stepLoad()
+ *
+ * Only options without section are loaded. Not available with A/B slots (see setBackupStorage).
+ * Until load finishes options not read yet keep their current (default) values; options changed while loading keep the new value.
+ *
+ * @return False on error (load or incremental save in progress, A/B slots or storage error)
+ */
+bool uEspConfigLib::beginLoad() {
+    if (_loader != 0 || _saving || _fsB != 0) {
+        return false;
+    }
+    if (_kv == 0 && !_fs->openToRead()) {
+        return false;
+    }
+    _loader = new uEspConfigLibLoader();
+    _loaded = false;
+    _loadCursor = list;
+    if (_kv != 0) {
+        char value[9];
+        if (_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) {
+            _schemaChanged = _kv->get(uEspConfigLib_SCHEMA_HEADER, value, sizeof(value)) && strtoul(value, 0, 16) != _schemaHash(0);
+        }
+    } else {
+        _schemaChanged = false;
+    }
+    if (_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) { // Options not stored have default value
+        _resetSection(0);
+    }
+    return true;
+}
+
+/**
+ * \brief Continues an incremental load started with beginLoad()
+ *
+ * @param lines Lines (or key/value records) to process in this call, at least one
+ * @return 100 when finished, 0 while loading. -1 on error (i.e.: a line longer than uEspConfigLibParser_MAX_SIZE) or if there is no load in progress
+ */
+int8_t uEspConfigLib::stepLoad(const unsigned int lines) {
+    unsigned int done = 0;
+    unsigned int limit = lines > 0 ? lines : 1;
+    if (_loader == 0) {
+        return -1;
+    }
+    unsigned long start = uEspConfigLib_micros();
+    if (_kv != 0) {
+        char value[uEspConfigLibParser_VALUE_SIZE];
+        for (; _loadCursor != 0 && done < limit; _loadCursor = _loadCursor->next) {
+            if (_loadCursor->section == 0) {
+                char * stored = uEspConfigLib_atomicLoad(_loadCursor->dirty) ? 0 : _kvRead(_loadCursor->name, value, uEspConfigLibParser_VALUE_SIZE);
+                if (stored != 0) {
+                    _copyValue(_loadCursor, stored);
+                    if (stored != value) {
+                        free(stored);
+                    }
+                }
+                done++;
+            }
+        }
+        if (_loadCursor != 0) {
+            _metrics.loadMicros += uEspConfigLib_micros() - start;
+            return 0;
+        }
+    } else {
+        uEspConfigLibParser * parser = &_loader->parser;
+        while (done < limit) {
+            if (_loader->position >= _loader->length) {
+                _loader->position = 0;
+                _loader->length = _fs->read(_loader->chunk, uEspConfigLib_READ_CHUNK_SIZE);
+                if (_loader->length == 0) {
+                    if (parser->finish()) {
+                        _loadParsed(parser);
+                    }
+                    break;
+                }
+            }
+            char c = _loader->chunk[_loader->position++];
+            if (parser->feed(c)) {
+                _loadParsed(parser);
+            }
+            if (c == '\n') {
+                done++;
+            }
+        }
+        if (done >= limit) {
+            _metrics.loadMicros += uEspConfigLib_micros() - start;
+            return 0;
+        }
+        _fs->closeFile();
+    }
+    bool result = !_loader->parser.discarded(); // Values of lines too long to be read are missing
+    delete _loader;
+    _loader = 0;
+    _loaded = result;
+    _metrics.loads++;
+    _metrics.loadMicros += uEspConfigLib_micros() - start;
+    if (!result) {
+        _metrics.loadErrors++;
+        return -1;
+    }
+    return 100;
+}
+
+/**
+ * \brief Checks if config file has been loaded
+ *
+ * @return True after a successful loadConfigFile() or when an incremental load finishes
+ */
+bool uEspConfigLib::isLoaded() {
+    return _loaded;
+}
+
+void uEspConfigLib::_loadParsed(uEspConfigLibParser * parser) {
+    if (strcmp(parser->name(), uEspConfigLib_SCHEMA_HEADER) == 0) {
+        _schemaChanged = (strtoul(parser->value(), 0, 16) != _schemaHash(0));
+        return;
+    }
+    uEspConfigLibList * slot = _findSlot(parser->name());
+    if (slot != 0 && slot->section == 0 && !uEspConfigLib_atomicLoad(slot->dirty)) { // Changes done while loading are kept
+        _copyValue(slot, parser->value());
+    }
+}
+
+/**
+ * \brief Enables or disables load profiling
+ *
+ * When enabled loadConfigFile() measures time spent on each phase: storage mount (on its constructor),
+ * file open, reads, parsing, setting values and file close. Later section loads are added to the same results.
+ *
+ * @param enabled True to enable
+ */
+void uEspConfigLib::setProfiling(const bool enabled) {
+    _profiling = enabled;
+}
+
+/**
+ * \brief Gets last load profiling results
+ *
+ * @return Timings, in microseconds
+ */
+uEspConfigLibTimings uEspConfigLib::getTimings() {
+    return _timings;
+}
+
+/**
+ * \brief Prints last load profiling results
+ *
+ * @param output Where to print, i.e.: Serial
+ */
+void uEspConfigLib::printTimings(Print &output) {
+    output.print("uEspConfigLib load (us): mount ");
+    output.print(_timings.mount);
+    output.print(_timings.formatted ? " (formatted)" : "");
+    output.print(", open ");
+    output.print(_timings.open);
+    output.print(", read ");
+    output.print(_timings.read);
+    output.print(", parse ");
+    output.print(_timings.parse);
+    output.print(", set ");
+    output.print(_timings.set);
+    output.print(", close ");
+    output.print(_timings.close);
+    output.print(", total ");
+    output.print(_timings.total);
+    output.print(" - ");
+    output.print((unsigned long) _timings.bytes);
+    output.print(" bytes, ");
+    output.print(_timings.options);
+    output.println(" options");
+}
+
+/**
+ * \brief Handles a load profiling JSON request
+ *
+ * Responds {"data":{"mount":0,"open":0,"read":0,"parse":0,"set":0,"close":0,"total":0,"bytes":0,"options":0,"formatted":0}}, times in microseconds
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
+ */
+void uEspConfigLib::handleTimingsJson(uEspConfigLib_WebServer * server) {
+    uEspConfigLibWebServerRequest request(server);
+    handleTimingsJson(&request);
+}
+
+/**
+ * \brief Handles a load profiling JSON request, on any web server
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ */
+void uEspConfigLib::handleTimingsJson(uEspConfigLibWebRequest * request) {
+    char buffer[256];
+    unsigned long start = uEspConfigLib_micros();
+    snprintf(buffer, sizeof(buffer), "{\"data\":{\"mount\":%lu,\"open\":%lu,\"read\":%lu,\"parse\":%lu,\"set\":%lu,\"close\":%lu,\"total\":%lu,\"bytes\":%lu,\"options\":%u,\"formatted\":%d}}",
+        _timings.mount, _timings.open, _timings.read, _timings.parse, _timings.set, _timings.close, _timings.total,
+        (unsigned long) _timings.bytes, _timings.options, _timings.formatted ? 1 : 0);
+    request->begin(200, "application/vnd.api+json");
+    request->sendContent(buffer);
+    request->end();
+    _countRequest(request, start);
+}
+
+/**
+ * \brief Gets operational metrics
+ *
+ * Loads, saves, web handler responses and WiFi scans are always counted. Heap is calculated on each call.
+ *
+ * @return Metrics
+ */
+uEspConfigLibMetrics uEspConfigLib::getMetrics() {
+    uEspConfigLibMetrics metrics = _metrics;
+    metrics.heap = _heapUsed();
+    return metrics;
+}
+
+/**
+ * \brief Handles a metrics request, in Prometheus text format
+ *
+ * Serves getMetrics() values and bytes written by each storage.
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
+ */
+void uEspConfigLib::handleMetrics(uEspConfigLib_WebServer * server) {
+    uEspConfigLibWebServerRequest request(server);
+    handleMetrics(&request);
+}
+
+/**
+ * \brief Handles a metrics request, on any web server
+ *
+ * @param request Request adapter (see uEspConfigLibWebRequest)
+ */
+void uEspConfigLib::handleMetrics(uEspConfigLibWebRequest * request) {
+    unsigned long start = uEspConfigLib_micros();
+    uEspConfigLibMetrics metrics = getMetrics();
+    request->begin(200, "text/plain; version=0.0.4");
+    _sendMetric(request, "loads_total", "counter", "Configuration loads", metrics.loads);
+    _sendMetric(request, "load_errors_total", "counter", "Failed configuration loads", metrics.loadErrors);
+    _sendMetric(request, "load_seconds_total", "counter", "Time spent loading configuration", metrics.loadMicros, true);
+    _sendMetric(request, "saves_total", "counter", "Configuration saves", metrics.saves);
+    _sendMetric(request, "save_errors_total", "counter", "Failed configuration saves", metrics.saveErrors);
+    _sendMetric(request, "save_seconds_total", "counter", "Time spent saving configuration", metrics.saveMicros, true);
+    _sendMetric(request, "http_requests_total", "counter", "Web handler requests", metrics.requests);
+    _sendMetric(request, "http_response_bytes_total", "counter", "Web handler response body bytes", metrics.responseBytes);
+    _sendMetric(request, "http_response_seconds_total", "counter", "Time spent on web handlers", metrics.responseMicros, true);
+    _sendMetric(request, "wifi_scans_total", "counter", "WiFi scans", metrics.scans);
+    _sendMetric(request, "heap_bytes", "gauge", "Heap owned by configuration and storages", metrics.heap);
+    request->sendContent("# HELP uespconfig_storage_written_bytes_total Bytes written to each storage\n# TYPE uespconfig_storage_written_bytes_total counter\n");
+    if (_kv != 0) {
+        _sendStorageMetric(request, "main", "", _kv->typeName(), _kv->bytesWritten());
+    } else {
+        _sendStorageMetric(request, "main", "", _fs->typeName(), _fs->bytesWritten());
+    }
+    if (_fsB != 0) {
+        _sendStorageMetric(request, "backup", "", _fsB->typeName(), _fsB->bytesWritten());
+    }
+    for (uEspConfigLibSection * section = _sections; section != 0; section = section->next) {
+        if (section->fs != 0) {
+            _sendStorageMetric(request, "section", section->name, section->fs->typeName(), section->fs->bytesWritten());
+        }
+    }
+    request->end();
+    _countRequest(request, start);
+}
+
+void uEspConfigLib::_sendMetric(uEspConfigLibWebRequest * request, const char * name, const char * type, const char * help, const uint64_t value, const bool seconds) {
+    char buffer[256];
+    char number[24];
+    uEspConfigLib_u64toa(number, seconds ? value / 1000000 : value);
+    if (seconds) {
+        snprintf(number + strlen(number), 8, ".%06lu", (unsigned long) (value % 1000000));
+    }
+    snprintf(buffer, sizeof(buffer), "# HELP uespconfig_%s %s\n# TYPE uespconfig_%s %s\nuespconfig_%s %s\n", name, help, name, type, name, number);
+    request->sendContent(buffer);
+}
+
+void uEspConfigLib::_sendStorageMetric(uEspConfigLibWebRequest * request, const char * storage, const char * section, const char * type, const size_t bytes) {
+    char buffer[uEspConfigLibParser_NAME_SIZE + 128];
+    snprintf(buffer, sizeof(buffer), "uespconfig_storage_written_bytes_total{storage=\"%s\",section=\"%s\",type=\"%s\"} %lu\n", storage, section, type, (unsigned long) bytes);
+    request->sendContent(buffer);
+}
+
+void uEspConfigLib::_countRequest(uEspConfigLibWebRequest * request, const unsigned long start) {
+    _metrics.requests++;
+    _metrics.responseBytes += request->sentBytes();
+    _metrics.responseMicros += uEspConfigLib_micros() - start;
+}
+
+void uEspConfigLib::_countSave(const bool result, const unsigned long start) {
+    _metrics.saves++;
+    _metrics.saveMicros += uEspConfigLib_micros() - start;
+    if (!result) {
+        _metrics.saveErrors++;
+    }
+}
+
+size_t uEspConfigLib::_heapUsed() {
+    size_t heap = 0;
+    _lock();
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        heap += sizeof(uEspConfigLibList) + uEspConfigLib_heapString(slot->name) + uEspConfigLib_heapString(slot->description)
+            + uEspConfigLib_heapString(slot->defaultValue) + uEspConfigLib_heapString(slot->value);
+    }
+    heap += sizeof(uEspConfigLibRetired) * _retiredSize;
+    for (uint16_t i = 0; i < _retiredCount; i++) {
+        heap += uEspConfigLib_heapString(_retired[i].value);
+    }
+    _unlock();
+    for (uEspConfigLibSection * section = _sections; section != 0; section = section->next) {
+        heap += sizeof(uEspConfigLibSection) + uEspConfigLib_heapString(section->name);
+        if (section->fs != 0) {
+            heap += section->fs->heapUsed();
+        }
+    }
+    if (_schemaSlots != 0) {
+        heap += _schema->count * sizeof(uEspConfigLibList *);
+    }
+    if (_sse != 0) {
+        heap += uEspConfigLib_SSE_CLIENTS * sizeof(uEspConfigLibSseClient);
+        for (uint8_t i = 0; i < uEspConfigLib_SSE_CLIENTS; i++) {
+            heap += _sse[i].pending.length();
+        }
+    }
+    if (_import != 0) {
+        heap += sizeof(uEspConfigLibParser);
+    }
+    if (_loader != 0) {
+        heap += sizeof(uEspConfigLibLoader);
+    }
+    if (_fs != 0) {
+        heap += _fs->heapUsed();
+    }
+    if (_fsB != 0) {
+        heap += _fsB->heapUsed();
+    }
+    return heap;
+}
+
+/**
+ * \brief Sets a second storage for A/B config slots
+ *
+ * Saves alternate between main storage and this one, writing a header with generation number and checksum.
+ * Loading reads only headers to choose newest slot and falls back to the other one if its checksum fails,
+ * so an interrupted save never loses last good configuration. Only options without section use slots.
+ *
+ * @param fs Selected uEspConfigLibFSInterface to be used as second slot
+ * @return False on error (key/value storage in use)
+ */
+bool uEspConfigLib::setBackupStorage(uEspConfigLibFSInterface * fs) {
+    if (_kv != 0) {
+        return false;
+    }
+    _fsB = fs;
+    return true;
+}
+
+uEspConfigLibFSInterface * uEspConfigLib::_mainFs() {
+    return (_fsB != 0 && _activeSlot == 1) ? _fsB : _fs;
+}
+
+bool uEspConfigLib::_readSlotHeader(uEspConfigLibFSInterface * fs, uint32_t * generation, uint32_t * crc, unsigned int * count) {
+    char line[64];
+    char * position;
+    bool result;
+    if (!fs->openToRead()) {
+        return false;
+    }
+    result = fs->readLine(line, sizeof(line));
+    fs->closeFile();
+    if (!result || strncmp(line, uEspConfigLib_SLOT_HEADER " = ", strlen(uEspConfigLib_SLOT_HEADER) + 3) != 0) {
+        return false;
+    }
+    position = line + strlen(uEspConfigLib_SLOT_HEADER) + 3;
+    *generation = strtoul(position, &position, 10);
+    *crc = strtoul(position, &position, 16);
+    *count = strtoul(position, &position, 10);
+    return *generation != 0;
+}
+
+bool uEspConfigLib::_loadSlots() {
+    uEspConfigLibFSInterface * slots[2] = {_fs, _fsB};
+    uint32_t generation[2] = {0, 0};
+    uint32_t expected[2];
+    unsigned int expectedCount[2];
+    uint32_t crc;
+    unsigned int count;
+    uint8_t order[2];
+    bool headers = false;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (_readSlotHeader(slots[i], &generation[i], &expected[i], &expectedCount[i])) {
+            headers = true;
+        } else {
+            generation[i] = 0;
+        }
+    }
+    if (!headers) { // Config file saved without slots, or none saved yet
+        return _loadFile(_fs, 0);
+    }
+    order[0] = (generation[1] > generation[0]) ? 1 : 0;
+    order[1] = 1 - order[0];
+    for (uint8_t i = 0; i < 2; i++) {
+        uint8_t slot = order[i];
+        if (generation[slot] == 0) {
+            continue;
+        }
+        if (_loadFile(slots[slot], 0, &crc, &count) && crc == expected[slot] && count == expectedCount[slot]) {
+            _activeSlot = slot;
+            _generation = generation[order[0]]; // Keep increasing after a fallback
+            return true;
+        }
+        _resetSection(0); // Do not keep values from a damaged slot
+    }
+    // Next save overwrites the newest, damaged, slot
+    _activeSlot = 1 - order[0];
+    _generation = generation[order[0]];
+    return false;
+}
+
+void uEspConfigLib::_resetSection(uEspConfigLibSection * section) {
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section == section && strcmp(slot->value, slot->defaultValue) != 0) {
+            _copyValue(slot, slot->defaultValue);
+        }
+    }
+}
+
+bool uEspConfigLib::_isSaved(uEspConfigLibList * slot, const char * value) {
+    return (_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) == 0 || strcmp(value, slot->defaultValue) != 0;
+}
+
+uint32_t uEspConfigLib::_schemaHash(uEspConfigLibSection * section) {
+    uint32_t hash = 2166136261UL; // FNV-1a
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section != section) {
+            continue;
+        }
+        for (const char * c = slot->name; ; c++) {
+            hash = (hash ^ (uint8_t) *c) * 16777619UL;
+            if (*c == 0) {
+                break;
+            }
+        }
+        for (const char * c = slot->defaultValue; ; c++) {
+            hash = (hash ^ (uint8_t) *c) * 16777619UL;
+            if (*c == 0) {
+                break;
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * \brief Sets how configuration is saved
+ *
+ * With uEspConfigLib_SAVE_NONDEFAULT_ONLY only options whose value differs from its default are stored, plus a hash
+ * of options names and defaults; loading then starts from defaults. On key/value storages default values are erased.
+ * With uEspConfigLib_SAVE_COMPACT files contain only name=value lines, without header nor per-option comments.
+ *
+ * @param flags uEspConfigLib_SAVE_* flags, combined with |. 0 to store every option (default)
+ */
+void uEspConfigLib::setSaveFlags(const uint8_t flags) {
+    _saveFlags = flags;
+}
+
+/**
+ * \brief Checks if main config file, or a section loaded after it, was saved with different options or defaults
+ *
+ * Only known when saved with uEspConfigLib_SAVE_NONDEFAULT_ONLY.
+ *
+ * @return True if options names or defaults changed since it was saved
+ */
+bool uEspConfigLib::isSchemaChanged() {
+    return _schemaChanged;
+}
+
+uint32_t uEspConfigLib::_slotChecksum(const char ** values, unsigned int * count) {
+    uint32_t crc = 0xFFFFFFFF;
+    uint16_t i = 0;
+    *count = 0;
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section != 0) {
+            continue;
+        }
+        if (_isSaved(slot, values[i])) {
+            crc = uEspConfigLib_crc32Pair(crc, slot->name, values[i]);
+            (*count)++;
+        }
+        i++;
+    }
+    return ~crc;
+}
+
+bool uEspConfigLib::_saveSlots() {
+    uint8_t target = 1 - _activeSlot;
+    if (!_saveFile(target == 0 ? _fs : _fsB, 0, _generation + 1)) {
+        return false; // Active slot is still the last good one
+    }
+    _activeSlot = target;
+    _generation++;
+    return true;
+}
+
+/**
+ * \brief Loads (or reloads) a section from its storage
+ *
+ * @param name Name of the section
+ * @return False on error
+ */
+bool uEspConfigLib::loadSection(const char * name) {
+    uEspConfigLibSection * section = _getSection(name, false);
+    if (section == 0) {
+        return false;
+    }
+    return _loadSection(section);
+}
+
+bool uEspConfigLib::_loadSection(uEspConfigLibSection * section) {
+    section->loaded = true; // Even on error, storage is not retried on every access
+    if (section->fs == 0) {
+        return false;
+    }
+    unsigned long start = uEspConfigLib_micros();
+    bool result = _loadFile(section->fs, section);
+    _metrics.loads++;
+    _metrics.loadMicros += uEspConfigLib_micros() - start;
+    if (!result) {
+        _metrics.loadErrors++;
+    }
+    return result;
+}
+
+bool uEspConfigLib::_loadFile(uEspConfigLibFSInterface * fs, uEspConfigLibSection * section, uint32_t * crc, unsigned int * count) {
+    bool result;
+    uEspConfigLibParser parser;
+	char chunk[uEspConfigLib_READ_CHUNK_SIZE];
+    size_t len;
+    bool last = false;
+    unsigned long start = 0;
+    unsigned long setStart = 0;
+    unsigned long setTime = 0;
+    if (_profiling) {
+        start = uEspConfigLib_micros();
+    }
+    result = fs->openToRead();
+    if (_profiling) {
+        _timings.open += uEspConfigLib_micros() - start;
+    }
+    if (!result) {
+        return false;
+    }
+    if (crc != 0) {
+        *crc = 0xFFFFFFFF;
+        *count = 0;
+    }
+    if (_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) { // Options not stored have default value
+        _resetSection(section);
+    }
+    if (section == 0) { // Section loads only add their own changes
+        _schemaChanged = false;
+    }
+    while (!last) {
+        if (_profiling) {
+            start = uEspConfigLib_micros();
+        }
+        len = fs->read(chunk, uEspConfigLib_READ_CHUNK_SIZE);
+        if (_profiling) {
+            setStart = uEspConfigLib_micros();
+            _timings.read += setStart - start;
+            _timings.bytes += len;
+            start = setStart;
+            setTime = 0;
+        }
+        last = (len == 0);
+        for (size_t i = 0; i <= len; i++) {
+            if (i < len ? !parser.feed(chunk[i]) : !(last && parser.finish())) {
+                continue;
+            }
+            if (strcmp(parser.name(), uEspConfigLib_SCHEMA_HEADER) == 0) {
+                if (strtoul(parser.value(), 0, 16) != _schemaHash(section)) {
+                    _schemaChanged = true;
+                }
+                continue;
+            }
+            if (crc != 0) {
+                if (strcmp(parser.name(), uEspConfigLib_SLOT_HEADER) == 0) {
+                    continue;
+                }
+                *crc = uEspConfigLib_crc32Pair(*crc, parser.name(), parser.value());
+                (*count)++;
+            }
+            if (_profiling) {
+                setStart = uEspConfigLib_micros();
+                _applyParsed(&parser, section);
+                setTime += uEspConfigLib_micros() - setStart;
+                _timings.options++;
+            } else {
+                _applyParsed(&parser, section);
+            }
+        }
+        if (_profiling) {
+            _timings.set += setTime;
+            _timings.parse += uEspConfigLib_micros() - start - setTime;
+        }
+        uEspConfigLibYield::step(len);
+    }
+    if (_profiling) {
+        start = uEspConfigLib_micros();
+    }
+    fs->closeFile();
+    if (_profiling) {
+        _timings.close += uEspConfigLib_micros() - start;
+    }
+    if (crc != 0) {
+        *crc = ~*crc;
+    }
+    return !parser.discarded(); // Values of lines too long to be read are missing
+}
+
+/**
+ * \brief Recreates and overwrites config file to FileSystem with current configurations
+ *
+ * When using a key/value storage every option record is written.
+ * Sections with changes are also saved to their own storages.
+ *
+ * @return False on error, or if an incremental save or load is in progress
+ */
+bool uEspConfigLib::saveConfigFile() {
+    if (_saving || _loader != 0) { // Storage is in use by an incremental save or load
+        return false;
+    }
+    _lock();
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section == 0) {
+            slot->dirty = true;
+        }
+    }
+    _mainDirty = true;
+    _unlock();
+    return _saveDirty();
+}
+
+/**
+ * \brief Starts an incremental save of config file, to be continued with stepSave()
+ *
+ * Only options without section are saved. Not available with A/B slots (see setBackupStorage).
+ * Changes done while saving are saved again later.
+ *
+ * @return False on error (save or incremental load in progress, A/B slots or storage error)
+ */
+bool uEspConfigLib::beginSave() {
+    if (_saving || _loader != 0 || _fsB != 0) {
+        return false;
+    }
+    if (_kv == 0 && !_fs->openToWrite()) {
+        return false;
+    }
+    _saving = true;
+    _saveResult = true;
+    _saveHeader = true;
+    _saveCursor = list;
+    _saveDone = 0;
+    _saveTotal = 0;
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section == 0) {
+            _saveTotal++;
+        }
+    }
+    _lock();
+    _mainDirty = false; // Changes done while saving will set it again
+    _unlock();
+    _updateDirty();
+    return true;
+}
+
+/**
+ * \brief Continues an incremental save started with beginSave()
+ *
+ * Writes whole options until budget is reached, at least one per call.
+ *
+ * @param budget Bytes to write in this call
+ * @return Progress, from 0 to 99 while saving and 100 when finished. -1 on error or if there is no save in progress
+ */
+int8_t uEspConfigLib::stepSave(const size_t budget) {
+    size_t written = 0;
+    if (!_saving) {
+        return -1;
+    }
+    unsigned long start = uEspConfigLib_micros();
+    if (_saveHeader) {
+        _saveHeader = false;
+        if (_kv != 0) {
+            _saveResult = _putSchema();
+        } else {
+            written = _writeHeader(_fs, 0, &_saveResult);
+            uEspConfigLibYield::step(written);
+        }
+        if (written >= budget) {
+            _metrics.saveMicros += uEspConfigLib_micros() - start;
+            return 0;
+        }
+    }
+    uint8_t parity = _readBegin();
+    while (_saveCursor != 0) {
+        uEspConfigLibList * slot = _saveCursor;
+        _saveCursor = slot->next;
+        if (slot->section != 0) {
+            continue;
+        }
+        _saveDone++;
+        size_t bytes = 0;
+        if (_kv != 0) {
+            if (uEspConfigLib_atomicLoad(slot->dirty)) {
+                const char * value = _takeValue(slot);
+                bytes = strlen(slot->name) + strlen(value);
+                _saveResult = _putOption(slot, value) && _saveResult;
+            }
+        } else {
+            bytes = _writeOption(_fs, slot, _takeValue(slot), &_saveResult);
+        }
+        uEspConfigLibYield::step(bytes);
+        written += bytes;
+        if (written >= budget) {
+            break;
+        }
+    }
+    _readEnd(parity);
+    if (_saveCursor != 0) {
+        _metrics.saveMicros += uEspConfigLib_micros() - start;
+        return _saveDone < _saveTotal ? _saveDone * 99 / _saveTotal : 99;
+    }
+    _saving = false;
+    if (_kv == 0) {
+        _saveResult = _fs->closeFile() && _saveResult;
+    }
+    _countSave(_saveResult, start);
+    if (!_saveResult) {
+        _lock();
+        _mainDirty = true;
+        _unlock();
+    }
+    _updateDirty();
+    return _saveResult ? 100 : -1;
+}
+
+/**
+ * \brief Checks if an incremental save is in progress
+ *
+ * @return True if saving
+ */
+bool uEspConfigLib::isSaving() {
+    return _saving;
+}
+
+/**
+ * \brief Sets write-behind mode to save config file incrementally from loop()
+ *
+ * @param budget Bytes written on each loop() call. 0 saves the whole file at once (default)
+ */
+void uEspConfigLib::setSaveStep(const size_t budget) {
+    _saveStep = budget;
+}
+
+/**
+ * \brief Recreates and overwrites a section storage with its current configurations
+ *
+ * @param name Name of the section
+ * @return False on error
+ */
+bool uEspConfigLib::saveSection(const char * name) {
+    uEspConfigLibSection * section = _getSection(name, false);
+    if (section == 0 || section->fs == 0) {
+        return false;
+    }
+    if (!section->loaded) { // Do not overwrite stored values with defaults
+        _loadSection(section);
+    }
+    unsigned long start = uEspConfigLib_micros();
+    _lock();
+    section->dirty = false; // Changes done while saving will set it again
+    _unlock();
+    bool result = _saveFile(section->fs, section);
+    _countSave(result, start);
+    if (!result) {
+        _lock();
+        section->dirty = true;
+        _unlock();
+    }
+    _updateDirty();
+    return result;
+}
+
+// Dirty flags are cleared before saving, under lock as other tasks may be changing options: a change done while
+// saving sets them again, and they are restored if saving fails
+bool uEspConfigLib::_saveDirty() {
+    bool result = true;
+    bool saved;
+    unsigned long start;
+    if (_saving || _loader != 0) { // Storage in use: saved from loop() once incremental save or load finishes
+        if (uEspConfigLib_atomicLoad(_mainDirty)) {
+            _saveDeferred = true;
+            result = false;
+        }
+    } else if (_takeDirty(&_mainDirty)) {
+        start = uEspConfigLib_micros();
+        saved = _kv != 0 ? _saveStore() : (_fsB != 0 ? _saveSlots() : _saveFile(_fs, 0));
+        if (!saved) {
+            _lock();
+            _mainDirty = true;
+            _unlock();
+            result = false;
+        }
+        _countSave(saved, start);
+    }
+    for (uEspConfigLibSection * section = _sections; section != 0; section = section->next) {
+        if (section->fs != 0 && _takeDirty(&section->dirty)) {
+            start = uEspConfigLib_micros();
+            saved = _saveFile(section->fs, section);
+            if (!saved) {
+                _lock();
+                section->dirty = true;
+                _unlock();
+                result = false;
+            }
+            _countSave(saved, start);
+        }
+    }
+    _updateDirty();
+    return result;
+}
+
+// Clears a dirty flag, returning its previous value
+bool uEspConfigLib::_takeDirty(bool * flag) {
+    _lock();
+    bool dirty = *flag;
+    *flag = false;
+    _unlock();
+    return dirty;
+}
+
+// Clears dirty flag of an option and takes its value at once, so a change done later marks it dirty again
+const char * uEspConfigLib::_takeValue(uEspConfigLibList * slot) {
+    _lock();
+    slot->dirty = false;
+    const char * value = uEspConfigLib_atomicLoad(slot->value);
+    _unlock();
+    return value;
+}
+
+void uEspConfigLib::_updateDirty() {
+    _lock();
+    _dirty = _mainDirty;
+    for (uEspConfigLibSection * section = _sections; section != 0; section = section->next) {
+        if (section->dirty && section->fs != 0) {
+            _dirty = true;
+        }
+    }
+    _unlock();
+}
+
+bool uEspConfigLib::_loadStore() {
+	char value[uEspConfigLibParser_VALUE_SIZE];
+    if (_kv->status() == uEspConfigLibFS_STATUS_FATAL) {
+        return false;
+    }
+    unsigned long start = 0;
+    if (_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) { // Options not stored have default value
+        _resetSection(0);
+        _schemaChanged = _kv->get(uEspConfigLib_SCHEMA_HEADER, value, uEspConfigLibParser_VALUE_SIZE) && strtoul(value, 0, 16) != _schemaHash(0);
+    }
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section != 0) {
+            continue;
+        }
+        if (_profiling) {
+            start = uEspConfigLib_micros();
+        }
+        char * stored = _kvRead(slot->name, value, uEspConfigLibParser_VALUE_SIZE);
+        if (stored != 0) {
+            uEspConfigLibYield::step(strlen(slot->name) + strlen(stored));
+            if (_profiling) {
+                unsigned long readEnd = uEspConfigLib_micros();
+                _timings.read += readEnd - start;
+                _copyValue(slot, stored);
+                _timings.set += uEspConfigLib_micros() - readEnd;
+                _timings.bytes += strlen(stored);
+                _timings.options++;
+            } else {
+                _copyValue(slot, stored);
+            }
+            if (stored != value) {
+                free(stored);
+            }
+        } else {
+            uEspConfigLibYield::step(strlen(slot->name));
+            if (_profiling) {
+                _timings.read += uEspConfigLib_micros() - start;
+            }
+        }
+    }
+    return true;
+}
+
+// Reads a stored value into buffer, or into heap if it does not fit (free it then). 0 if not stored or on error
+char * uEspConfigLib::_kvRead(const char * key, char * buffer, const size_t size) {
+    if (_kv->get(key, buffer, size)) {
+        return buffer;
+    }
+    size_t length = _kv->length(key);
+    if (length < size) { // Not stored, or storage error
+        return 0;
+    }
+    char * value = (char *) malloc(length + 1);
+    if (value != 0 && !_kv->get(key, value, length + 1)) {
+        free(value);
+        value = 0;
+    }
+    return value;
+}
+
+bool uEspConfigLib::_saveStore() {
+    bool result = _putSchema();
+    uint8_t parity = _readBegin();
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section == 0 && uEspConfigLib_atomicLoad(slot->dirty)) {
+            const char * value = _takeValue(slot);
+            result = _putOption(slot, value) && result;
+            uEspConfigLibYield::step(strlen(slot->name) + strlen(value));
+        }
+    }
+    _readEnd(parity);
+    return result;
+}
+
+bool uEspConfigLib::_putSchema() {
+    char hash[9];
+    if (!(_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY)) {
+        return true;
+    }
+    snprintf(hash, sizeof(hash), "%08lx", (unsigned long) _schemaHash(0));
+    return _kv->put(uEspConfigLib_SCHEMA_HEADER, hash);
+}
+
+// Value is taken with _takeValue(), option is marked dirty again if it cannot be stored
+bool uEspConfigLib::_putOption(uEspConfigLibList * slot, const char * value) {
+    if (!_isSaved(slot, value)) {
+        _kv->erase(slot->name); // Fails if it was not stored, also fine
+    } else if (!_kv->put(slot->name, value)) {
+        _lock();
+        slot->dirty = true;
+        _unlock();
+        return false;
+    }
+    return true;
+}
+
+bool uEspConfigLib::_saveFile(uEspConfigLibFSInterface * fs, uEspConfigLibSection * section, const uint32_t generation) {
+    bool result;
+    char header[64];
+    unsigned int count;
+    const char ** values = 0;
+    uint16_t i = 0;
+    
+    result = fs->openToWrite();
+    if (!result) {
+        return false;
+    }
+    uint8_t parity = _readBegin(); // Keeps snapshot values alive while writing
+    if (generation != 0) { // A/B slot: checksum and written values must match, take them at once
+        for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+            if (slot->section == 0) {
+                i++;
+            }
+        }
+        values = new const char *[i];
+        i = 0;
+        _lock();
+        for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+            if (slot->section == 0) {
+                slot->dirty = false;
+                values[i] = uEspConfigLib_atomicLoad(slot->value);
+                i++;
+            }
+        }
+        _unlock();
+        uint32_t crc = _slotChecksum(values, &count);
+        snprintf(header, sizeof(header), uEspConfigLib_SLOT_HEADER " = %lu %08lx %u\n", (unsigned long) generation, (unsigned long) crc, count);
+        result = fs->write(header);
+        uEspConfigLibYield::step(strlen(header));
+    }
+    uEspConfigLibYield::step(_writeHeader(fs, section, &result));
+    i = 0;
+    for (uEspConfigLibList * slot = list; slot != 0; slot = slot->next) {
+        if (slot->section != section) {
+            continue;
+        }
+        uEspConfigLibYield::step(_writeOption(fs, slot, values != 0 ? values[i] : _takeValue(slot), &result));
+        i++;
+    }
+    _readEnd(parity);
+    delete[] values;
+    result = fs->closeFile() && result; // A partial file is never reported as saved, so A/B slot is not switched
+	return result;
+}
+
+// Write functions set result to false on a write error, and write nothing once it is false
+size_t uEspConfigLib::_writeHeader(uEspConfigLibFSInterface * fs, uEspConfigLibSection * section, bool * result) {
+    char header[64];
+    size_t written = 0;
+    bool compact = (_saveFlags & uEspConfigLib_SAVE_COMPACT) != 0;
+    if (!*result) {
+        return 0;
+    }
+    if (!compact) {
+        const char * lines[] = {
+            "# uConfigLib Configuration file\n",
+            "# Visit https://github.com/Naguissa/uEspConfigLib for details\n",
+            "# Syntax:\n",
+            "# variable = value\n",
+            "# (spaces and empty lines doesn't care)\n",
+            "# This file comments: lines starting with #, ; or //\n"
+        };
+        for (uint8_t i = 0; i < sizeof(lines) / sizeof(lines[0]) && *result; i++) {
+            *result = fs->write(lines[i]);
+            written += strlen(lines[i]);
+        }
+    }
+    if ((_saveFlags & uEspConfigLib_SAVE_NONDEFAULT_ONLY) && *result) {
+        if (!compact) {
+            const char * line = "\n# Only values different from default are stored\n";
+            *result = fs->write(line);
+            written += strlen(line);
+        }
+        snprintf(header, sizeof(header), compact ? uEspConfigLib_SCHEMA_HEADER "=%08lx\n" : uEspConfigLib_SCHEMA_HEADER " = %08lx\n", (unsigned long) _schemaHash(section));
+        *result = *result && fs->write(header);
+        written += strlen(header);
+    }
+    return written;
+}
+
+size_t uEspConfigLib::_writeOption(uEspConfigLibFSInterface * fs, uEspConfigLibList * slot, const char * value, bool * result) {
+    size_t written = 0;
+    if (!*result || !_isSaved(slot, value)) {
+        return 0;
+    }
+    if (_saveFlags & uEspConfigLib_SAVE_COMPACT) {
+        const char * parts[] = {slot->name, "=", value, "\n"};
+        for (uint8_t i = 0; i < sizeof(parts) / sizeof(parts[0]) && *result; i++) {
+            *result = fs->write(parts[i]);
+            written += strlen(parts[i]);
+        }
+        return written;
+    }
+    const char * parts[] = {"\n# ", slot->name, " -- ", slot->description, "\n# Default value: ", slot->defaultValue, "\n", slot->name, " = ", value, "\n"};
+    for (uint8_t i = 0; i < sizeof(parts) / sizeof(parts[0]) && *result; i++) {
+        *result = fs->write(parts[i]);
+        written += strlen(parts[i]);
+    }
+    return written;
+}
+
+/**
+ * \brief Enables write-behind mode, saving config file from loop() some time after last change
+ *
+ * When enabled, changes done with set(), clear() or handleSaveConfig() mark configuration as pending to be saved
+ * and loop() saves it once when no more changes arrive during quiet period.
+ *
+ * @param quiet Milliseconds without changes before saving. 0 disables write-behind mode (default)
+ * @param maxDelay Optional. Maximum milliseconds a change can wait to be saved, even if changes keep arriving. 0 for no limit
+ */
+void uEspConfigLib::setSaveDelay(const unsigned long quiet, const unsigned long maxDelay) {
+    _saveDelay = quiet;
+    _saveMaxDelay = maxDelay;
+}
+
+/**
+ * \brief Periodic task, saves pending changes in write-behind mode and sends queued server-sent events
+ *
+ * It also continues incremental saves when setSaveStep is used.
+ *
+ * Call it from your sketch loop()
+ */
+void uEspConfigLib::loop() {
+    if (_sse != 0) {
+        _ssePump();
+    }
+    if (_concurrent && _retiredCount > 0) {
+        _lock();
+        _reclaim();
+        _unlock();
+    }
+    unsigned long now = millis();
+    if (_loader != 0) { // Not saved until incremental load finishes, as it would overwrite values not read yet
+        return;
+    }
+    if (_saving) {
+        if (_saveStep != 0 && stepSave(_saveStep) < 0) { // Retry later
+            _lock();
+            _dirtySince = now;
+            _lastChange = now;
+            _unlock();
+        }
+        return;
+    }
+    _lock(); // Options may be changed from other tasks
+    bool dirty = _dirty;
+    unsigned long lastChange = _lastChange;
+    unsigned long dirtySince = _dirtySince;
+    _unlock();
+    if (!dirty) {
+        _saveDeferred = false;
+        return;
+    }
+    if (_saveDelay == 0 && !_saveDeferred) {
+        return;
+    }
+    if (_saveDelay != 0 && now - lastChange < _saveDelay && (_saveMaxDelay == 0 || now - dirtySince < _saveMaxDelay)) {
+        return;
+    }
+    if (!_takeSaveToken()) { // Rate limited, retried on next calls
+        return;
+    }
+    _saveDeferred = false;
+    if (_saveStep != 0 && uEspConfigLib_atomicLoad(_mainDirty) && beginSave()) { // Continued on next calls
+        return;
+    }
+    if (!_saveDirty()) { // Retry later
+        _lock();
+        _dirty = true;
+        _dirtySince = now;
+        _lastChange = now;
+        _unlock();
+    }
+}
+
+/**
+ * \brief Limits saves done by handleSaveConfig(), handleConfigDownload() and loop(), using a token bucket
+ *
+ * Up to burst saves are allowed at once, and one more each interval. When limit is reached handleSaveConfig()
+ * rejects the request with 429 status or, by default, applies values and defers saving to loop(), joining all
+ * changes in one save. saveConfigFile() and flush() are not limited.
+ *
+ * @param burst Saves allowed at once. 0 disables limit (default)
+ * @param interval Milliseconds to recover one save
+ * @param policy Optional. uEspConfigLib_RATE_DEFER (default) or uEspConfigLib_RATE_REJECT
+ */
+void uEspConfigLib::setSaveRateLimit(const uint8_t burst, const unsigned long interval, const uint8_t policy) {
+    _rateBurst = burst;
+    _rateTokens = burst;
+    _rateInterval = interval;
+    _ratePolicy = policy;
+    _rateLast = millis();
+}
+
+bool uEspConfigLib::_takeSaveToken() {
+    if (_rateBurst == 0) {
+        return true;
+    }
+    unsigned long now = millis();
+    if (_rateTokens >= _rateBurst) { // Full bucket does not accumulate time
+        _rateLast = now;
+    } else if (_rateInterval == 0) {
+        _rateTokens = _rateBurst;
+    } else if (now - _rateLast >= _rateInterval) {
+        unsigned long refill = (now - _rateLast) / _rateInterval;
+        if (refill >= (unsigned long) (_rateBurst - _rateTokens)) {
+            _rateTokens = _rateBurst;
+            _rateLast = now;
+        } else {
+            _rateTokens += refill;
+            _rateLast += refill * _rateInterval;
+        }
+    }
+    if (_rateTokens == 0) {
+        return false;
+    }
+    _rateTokens--;
+    return true;
+}
+
+/**
+ * \brief Saves pending changes immediately, if any
+ *
+ * @return False on error, or if an incremental save or load is in progress (changes are then saved from loop())
+ */
+bool uEspConfigLib::flush() {
+    if (!uEspConfigLib_atomicLoad(_dirty)) {
+        return true;
+    }
+    return _saveDirty();
+}
+
+/**
+ * \brief Checks if there are changes not saved yet
+ *
+ * @return True if there are pending changes
+ */
+bool uEspConfigLib::isDirty() {
+    return uEspConfigLib_atomicLoad(_dirty);
+}
+
+void uEspConfigLib::_markDirty(uEspConfigLibList * slot) {
+    _sseQueue(slot);
+    _lock();
+    slot->dirty = true;
+    if (slot->section == 0) {
+        _mainDirty = true;
+    } else {
+        slot->section->dirty = true;
+    }
+    _lastChange = millis();
+    if (!_dirty) {
+        _dirtySince = _lastChange;
+        _dirty = true;
+    }
+    _unlock();
+}
+
+void uEspConfigLib::_handleWifiScan(uEspConfigLibWebRequest * request, const String field) {
+    _metrics.scans++;
+    request->begin(200, "text/html");
+    request->sendContent("<html><head><title>IoT device config - uConfigLib</title></head><body><p><b>WiFi networks:</b></p>");
 
     int n = WiFi.scanNetworks();
     if (n == 0) {
-        server->sendContent("<p><i>No networks found</i></p>");
-        yield();
+        request->sendContent("<p><i>No networks found</i></p>");
     } else {
-        server->sendContent("<ul>");
+        request->sendContent("<ul>");
         for (int i = 0; i < n; i++) {
-            server->sendContent("<li><a href=\"javascript:window.opener.document.getElementById('" + field + "').value='" + WiFi.SSID(i) + "';window.close();\">" + WiFi.SSID(i) + " - Channel: " + WiFi.channel(i) + " - RSSI: " + WiFi.RSSI(i) + " - Encription: ");
-            yield();
+            request->sendContent("<li><a href=\"javascript:window.opener.document.getElementById('" + field + "').value='" + WiFi.SSID(i) + "';window.close();\">" + WiFi.SSID(i) + " - Channel: " + WiFi.channel(i) + " - RSSI: " + WiFi.RSSI(i) + " - Encription: ");
             switch (WiFi.encryptionType(i)) {
                 #ifdef ARDUINO_ARCH_ESP32
-                    case WIFI_AUTH_OPEN: server->sendContent("None"); break;
-                    case WIFI_AUTH_WEP: server->sendContent("WEP"); break;
-                    case WIFI_AUTH_WPA_PSK: server->sendContent("WPA/PSK"); break;
-                    case WIFI_AUTH_WPA2_PSK: server->sendContent("WPA2/PSK"); break;
-                    case WIFI_AUTH_WPA_WPA2_PSK: server->sendContent("WPA+WPA2/PSK"); break;
-                    case WIFI_AUTH_WPA2_ENTERPRISE: server->sendContent("WPA2/EAP"); break;
-                    case WIFI_AUTH_WPA3_PSK: server->sendContent("WPA3/PSK"); break;
-                    case WIFI_AUTH_WPA2_WPA3_PSK: server->sendContent("WPA2+WPA3/PSK"); break;
-                    case WIFI_AUTH_WAPI_PSK: server->sendContent("WAPI"); break;
+                    case WIFI_AUTH_OPEN: request->sendContent("None"); break;
+                    case WIFI_AUTH_WEP: request->sendContent("WEP"); break;
+                    case WIFI_AUTH_WPA_PSK: request->sendContent("WPA/PSK"); break;
+                    case WIFI_AUTH_WPA2_PSK: request->sendContent("WPA2/PSK"); break;
+                    case WIFI_AUTH_WPA_WPA2_PSK: request->sendContent("WPA+WPA2/PSK"); break;
+                    case WIFI_AUTH_WPA2_ENTERPRISE: request->sendContent("WPA2/EAP"); break;
+                    case WIFI_AUTH_WPA3_PSK: request->sendContent("WPA3/PSK"); break;
+                    case WIFI_AUTH_WPA2_WPA3_PSK: request->sendContent("WPA2+WPA3/PSK"); break;
+                    case WIFI_AUTH_WAPI_PSK: request->sendContent("WAPI"); break;
                 #else
-                    case ENC_TYPE_WEP: server->sendContent("WEP"); break;
-                    case ENC_TYPE_TKIP: server->sendContent("WPA/PSK"); break;
-                    case ENC_TYPE_CCMP: server->sendContent("WPA2/PSK"); break;
-                    case ENC_TYPE_NONE: server->sendContent("NONE"); break;
-                    case ENC_TYPE_AUTO: server->sendContent("WPA+WPA2/PSK"); break;
+                    case ENC_TYPE_WEP: request->sendContent("WEP"); break;
+                    case ENC_TYPE_TKIP: request->sendContent("WPA/PSK"); break;
+                    case ENC_TYPE_CCMP: request->sendContent("WPA2/PSK"); break;
+                    case ENC_TYPE_NONE: request->sendContent("NONE"); break;
+                    case ENC_TYPE_AUTO: request->sendContent("WPA+WPA2/PSK"); break;
                 #endif
-                default: server->sendContent("Unknown"); break;
+                default: request->sendContent("Unknown"); break;
             }
-            server->sendContent("</a></li>");
-            yield();
+            request->sendContent("</a></li>");
         }
-        server->sendContent("</ul>");
+        request->sendContent("</ul>");
     }
+    request->end();
 }
 
 
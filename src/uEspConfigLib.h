@@ -29,13 +29,13 @@
     #include "ESP8266WebServer.h"
 #endif
 #include "uEspConfigLibFSInterface.h"
-#ifdef ARDUINO_ARCH_ESP32
-    #include "WebServer.h"
-    #define uEspConfigLib_WebServer WebServer
-#else
-    #include "ESP8266WebServer.h"
-    #define uEspConfigLib_WebServer ESP8266WebServer
-#endif
+#include "uEspConfigLibKVInterface.h"
+#include "uEspConfigLibMetrics.h"
+#include "uEspConfigLibParser.h"
+#include "uEspConfigLibSchema.h"
+#include "uEspConfigLibWebRequest.h"
+#include "uEspConfigLibWebServerRequest.h"
+#include "uEspConfigLibYield.h"
 
 
 /**
@@ -47,20 +47,144 @@
  */
 #define uEspConfigLib_OPTION_SCANNER 1
 
+/**
+ * \brief Concurrent mode: initial capacity of the list of replaced values waiting for readers to end before being freed
+ *
+ * List grows when needed, writers never wait for readers.
+ */
+#ifndef uEspConfigLib_RETIRED_SIZE
+    #define uEspConfigLib_RETIRED_SIZE 8
+#endif
+
+/**
+ * \brief Save flag: store only options whose value differs from its default
+ */
+#define uEspConfigLib_SAVE_NONDEFAULT_ONLY 1
+/**
+ * \brief Save flag: write only name=value lines, without comments
+ */
+#define uEspConfigLib_SAVE_COMPACT 2
+
+/**
+ * \brief Save rate limit policy: apply values and save them later from loop()
+ */
+#define uEspConfigLib_RATE_DEFER 0
+/**
+ * \brief Save rate limit policy: reject save requests with 429 status
+ */
+#define uEspConfigLib_RATE_REJECT 1
+
+/**
+ * \brief Name of the schema hash line, written when storing only non-default values
+ */
+#define uEspConfigLib_SCHEMA_HEADER "uEspConfigLib_schema"
+
+/**
+ * \brief A/B slots: name of the header line, first line of each slot file
+ */
+#define uEspConfigLib_SLOT_HEADER "uEspConfigLib_slot"
+
+/**
+ * \brief Server-sent events: maximum simultaneous clients
+ */
+#ifndef uEspConfigLib_SSE_CLIENTS
+    #define uEspConfigLib_SSE_CLIENTS 4
+#endif
+
+/**
+ * \brief Server-sent events: changed options queued per client before asking it to reload everything
+ */
+#ifndef uEspConfigLib_SSE_QUEUE_SIZE
+    #define uEspConfigLib_SSE_QUEUE_SIZE 8
+#endif
+
+/**
+ * \brief Server-sent events: milliseconds between keep-alive comments
+ */
+#ifndef uEspConfigLib_SSE_KEEPALIVE
+    #define uEspConfigLib_SSE_KEEPALIVE 15000
+#endif
+
+/**
+ * \brief Server-sent events: bytes of events kept per client while its connection cannot take them. A longer event is kept alone
+ */
+#ifndef uEspConfigLib_SSE_BUFFER_SIZE
+    #define uEspConfigLib_SSE_BUFFER_SIZE 1024
+#endif
+
+/**
+ * \brief Size of chunks read from storage when loading config file
+ */
+#ifndef uEspConfigLib_READ_CHUNK_SIZE
+    #define uEspConfigLib_READ_CHUNK_SIZE 128
+#endif
+
+
+/**
+ * \brief Load profiling results, in microseconds (see setProfiling)
+ */
+struct uEspConfigLibTimings {
+    uEspConfigLibTimings() : mount(0), open(0), read(0), parse(0), set(0), close(0), total(0), bytes(0), options(0), formatted(false) {};
+    unsigned long mount;
+    unsigned long open;
+    unsigned long read;
+    unsigned long parse;
+    unsigned long set;
+    unsigned long close;
+    unsigned long total;
+    size_t bytes;
+    unsigned int options;
+    bool formatted;
+};
+
+struct uEspConfigLibLoader {
+    uEspConfigLibLoader() : length(0), position(0) {};
+    uEspConfigLibParser parser;
+    char chunk[uEspConfigLib_READ_CHUNK_SIZE];
+    size_t length;
+    size_t position;
+};
+
+struct uEspConfigLibSection {
+    uEspConfigLibSection() : next(0), name(0), fs(0), loaded(false), dirty(false) {};
+    uEspConfigLibSection *next;
+    char * name;
+    uEspConfigLibFSInterface * fs;
+    bool loaded;
+    bool dirty;
+};
+
+struct uEspConfigLibList;
+
+struct uEspConfigLibRetired {
+    char * value;
+    uint32_t epoch;
+};
+
+struct uEspConfigLibSseClient {
+    uEspConfigLibSseClient() : stream(0), overflow(false), count(0), lastSent(0) {};
+    uEspConfigLibStream * stream; // Null when slot is free
+    String pending; // Events not taken by connection yet
+    bool overflow;
+    uint8_t count;
+    unsigned long lastSent;
+    uEspConfigLibList * queue[uEspConfigLib_SSE_QUEUE_SIZE];
+};
 
 struct uEspConfigLibList {
-    uEspConfigLibList() : next(0), name(0), description(0), defaultValue(0), value(0), option(uEspConfigLib_OPTION_NONE) {};
+    uEspConfigLibList() : next(0), name(0), description(0), defaultValue(0), value(0), option(uEspConfigLib_OPTION_NONE), section(0), dirty(false) {};
     uEspConfigLibList *next;
     char * name;
     char * description;
     char * defaultValue;
     char * value;
     uint8_t option;
+    uEspConfigLibSection * section;
+    bool dirty;
 };
 
 #define uEspConfigLib_free(field) if (field != 0) { free(field); field = 0; }
 #define uEspConfigLib_malloc(value) (char *) malloc(sizeof(char) * (strlen(value) + 1))
-#define uEspConfigLib_WebServer_sendContent(data) if (*data != 0) { server->sendContent(data); }
 
 class uEspConfigLib {
     public:
@@ -70,6 +194,15 @@ class uEspConfigLib {
 		 * @param fs Selected uEspConfigLibFSInterface to be used
 		 */
         uEspConfigLib(uEspConfigLibFSInterface *);
+
+		/**
+		 * \brief Constructor, using a key/value storage
+		 *
+		 * Each option is stored as an independent record, so changing one option writes only that record.
+		 *
+		 * @param kv Selected uEspConfigLibKVInterface to be used
+		 */
+        uEspConfigLib(uEspConfigLibKVInterface *);
         
         // Regular usage functions
 		/**
@@ -82,6 +215,40 @@ class uEspConfigLib {
 		 */
         void addOption(const char *, const char *, const char *, const uint8_t = uEspConfigLib_OPTION_NONE);
 
+		/**
+		 * \brief Defines a configuration option inside a section
+		 *
+		 * Section options are stored in section's own storage, loaded on first access and saved only when changed.
+		 * Option names must be unique among all sections.
+		 *
+		 * @param section Name of the section, see addSection
+		 * @param name Name of configuration option
+		 * @param description Description of the configuration option
+		 * @param defaultValue Default value of the configuration option
+		 * @param option Special option, i.e.: uEspConfigLib_OPTION_NONE
+		 */
+        void addOption(const char *, const char *, const char *, const char *, const uint8_t);
+
+		/**
+		 * \brief Defines a section, a group of options stored on its own storage
+		 *
+		 * @param name Name of the section
+		 * @param fs Selected uEspConfigLibFSInterface to be used for this section (i.e.: another file path)
+		 */
+        void addSection(const char *, uEspConfigLibFSInterface *);
+
+        /**
+         * \brief Defines all options of a generated schema
+         *
+         * Schemas are generated from a schema file by extras/schema_generator/uEspConfigLib_schema.py. Option names found
+         * in the schema are then looked up with one hash and one compare. Only one schema can be added.
+         *
+         * @param schema Generated schema
+         * @param section Optional. Name of the section for all schema options, see addSection
+         * @return False on error (schema already added or section not defined)
+         */
+        bool addSchema(const uEspConfigLibSchema *, const char * = 0);
+
         /**
          * \brief Changes a configuration option current value
          *
@@ -99,6 +266,36 @@ class uEspConfigLib {
          */
         char * getPointer(const char *);
 
+        /**
+         * \brief Copies current value of a configuration option, safe to be used from any task in concurrent mode
+         *
+         * @param name Name of configuration option
+         * @param buffer Buffer where value will be copied
+         * @param size Buffer size, including string terminator. Longer values are truncated
+         * @return False on error (name not defined previously)
+         */
+        bool get(const char *, char *, const size_t);
+
+        /**
+         * \brief Gets configuration version, incremented on each value change
+         *
+         * Lets tasks detect changes without copying values.
+         *
+         * @return Current version
+         */
+        uint32_t version();
+
+        /**
+         * \brief Enables or disables concurrent mode, for ESP32 tasks reading configuration while it is changed
+         *
+         * In concurrent mode values are replaced atomically and old ones are freed only when no reader is copying them,
+         * so get() is safe from any task without blocking. Pointers from getPointer() are only valid until option changes.
+         * Enable it at setup, before starting tasks that use the configuration. Defining options is not thread-safe.
+         *
+         * @param enabled True to enable
+         */
+        void setConcurrentMode(const bool);
+
         /**
          * \brief Changes a configuration option to its default value
          *
@@ -118,6 +315,14 @@ class uEspConfigLib {
          */
         void handleConfigRequestHtml(uEspConfigLib_WebServer *, const char * = "/uConfigLib/saveConfig");
 
+        /**
+         * \brief Handles a configuration HTML form request, on any web server
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         * @param path Path where the form will be sent
+         */
+        void handleConfigRequestHtml(uEspConfigLibWebRequest *, const char * = "/uConfigLib/saveConfig");
+
         /**
          * \brief Handles a configuration JSON request
          *
@@ -150,10 +355,18 @@ class uEspConfigLib {
          */
         void handleConfigRequestJson(uEspConfigLib_WebServer *);
 
+        /**
+         * \brief Handles a configuration JSON request, on any web server
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleConfigRequestJson(uEspConfigLibWebRequest *);
+
         /**
          * \brief Handles a save configuration request
          *
          * This will handle the request and parameters, change any existing one and save the config file.
+         * In write-behind mode (see setSaveDelay) the config file is saved later from loop() instead.
          * If a config option is not set as parameter will be ignored. If a config option is empty it will be stored as empty.
          * It usually will respond with a 302 redirect to /?saved=1, but if "format" paramer is passed with "json" value it will respond as JSON:
          *  {
@@ -162,9 +375,114 @@ class uEspConfigLib {
          *     }
          * }
          *
+         * When save rate limit is reached (see setSaveRateLimit), or an incremental save or load is in progress, saving is deferred to loop(), adding "deferred": 1 to JSON response
+         * and &deferred=1 to redirect, or request is rejected with 429 status.
+         *
          * @param server WebServer or ESP8266WebServer variable, depending on architecture
          */
         void handleSaveConfig(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles a save configuration request, on any web server
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleSaveConfig(uEspConfigLibWebRequest *);
+
+        /**
+         * \brief Handles a configuration download request, streaming stored config file in chunks
+         *
+         * Pending changes are saved first. Use "section" argument to download a section file instead of main one.
+         * Main config file is not available (503 status) while an incremental save or load is in progress.
+         * When using a key/value storage main options are sent in config file syntax.
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        void handleConfigDownload(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles a configuration download request, on any web server
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleConfigDownload(uEspConfigLibWebRequest *);
+
+        /**
+         * \brief Handles a config file upload, receiving it in chunks
+         *
+         * Use it as upload handler: server.on(path, HTTP_POST, handleConfigImport, handleConfigUpload).
+         * Uploaded file is parsed as it arrives, so it is never fully stored in RAM.
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        void handleConfigUpload(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles the response of a config file upload
+         *
+         * It responds as handleSaveConfig, with result 0 if import failed.
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        void handleConfigImport(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles the response of a config file upload, on any web server
+         *
+         * Reports the result of last beginImport() and endImport().
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleConfigImport(uEspConfigLibWebRequest *);
+
+        /**
+         * \brief Handles a server-sent events (text/event-stream) request, pushing configuration changes
+         *
+         * Each change done with set(), clear(), handleSaveConfig() or an import sends a "change" event with
+         * {"name":"variable_name","value":"variable_current_value"} data. Changes are queued per client and sent from loop().
+         * If a client queue overflows, or its connection cannot take more data without blocking, pending events are dropped and
+         * it receives a "reload" event instead, meaning it should read all configuration again.
+         * Connection stays open after handler returns, served from loop(); response ends when connection is closed.
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        void handleConfigEvents(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles a server-sent events request, on any web server supporting streams
+         *
+         * Responds with 501 status if request adapter does not support streams (see uEspConfigLibWebRequest::openStream).
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleConfigEvents(uEspConfigLibWebRequest *);
+
+        /**
+         * \brief Starts importing a config file received in chunks
+         *
+         * @return False on error (import already in progress or out of memory)
+         */
+        bool beginImport();
+
+        /**
+         * \brief Processes a chunk of an imported config file
+         *
+         * Known options are changed as soon as they are parsed; unknown ones are ignored.
+         *
+         * @param data Chunk data
+         * @param len Chunk length
+         * @return False on error (no import in progress)
+         */
+        bool importChunk(const char *, const size_t);
+
+        /**
+         * \brief Ends importing a config file and saves changed options
+         *
+         * In write-behind mode (see setSaveDelay), or while an incremental save or load is in progress, changes are saved later from loop() instead.
+         *
+         * @return False on error (i.e.: a line longer than uEspConfigLibParser_MAX_SIZE, or save failed)
+         */
+        bool endImport();
         
         
         // FS functions
@@ -172,17 +490,245 @@ class uEspConfigLib {
         /**
          * \brief Loads config file from FileSystem and processes it
          *
-         * @return False on error
+         * When using a key/value storage each option is read from its record.
+         * Only options without section are loaded, each section is loaded on first access.
+         * A pending incremental load (see beginLoad) is aborted and done again from the beginning.
+         *
+         * @return False on error (i.e.: a line longer than uEspConfigLibParser_MAX_SIZE), or if an incremental save is in progress
          */
         bool loadConfigFile();
 
+        /**
+         * \brief Starts an incremental load of config file, to be continued with stepLoad()
+         *
+         * Only options without section are loaded. Not available with A/B slots (see setBackupStorage).
+         * Until load finishes options not read yet keep their current (default) values; options changed while loading keep the new value.
+         *
+         * @return False on error (load or incremental save in progress, A/B slots or storage error)
+         */
+        bool beginLoad();
+
+        /**
+         * \brief Continues an incremental load started with beginLoad()
+         *
+         * @param lines Lines (or key/value records) to process in this call, at least one
+         * @return 100 when finished, 0 while loading. -1 on error (i.e.: a line longer than uEspConfigLibParser_MAX_SIZE) or if there is no load in progress
+         */
+        int8_t stepLoad(const unsigned int);
+
+        /**
+         * \brief Checks if config file has been loaded
+         *
+         * @return True after a successful loadConfigFile() or when an incremental load finishes
+         */
+        bool isLoaded();
+
+        /**
+         * \brief Sets a second storage for A/B config slots
+         *
+         * Saves alternate between main storage and this one, writing a header with generation number and checksum.
+         * Loading reads only headers to choose newest slot and falls back to the other one if its checksum fails,
+         * so an interrupted save never loses last good configuration. Only options without section use slots.
+         *
+         * @param fs Selected uEspConfigLibFSInterface to be used as second slot
+         * @return False on error (key/value storage in use)
+         */
+        bool setBackupStorage(uEspConfigLibFSInterface *);
+
+        /**
+         * \brief Enables or disables load profiling
+         *
+         * When enabled loadConfigFile() measures time spent on each phase: storage mount (on its constructor),
+         * file open, reads, parsing, setting values and file close. Later section loads are added to the same results.
+         *
+         * @param enabled True to enable
+         */
+        void setProfiling(const bool);
+
+        /**
+         * \brief Sets how configuration is saved
+         *
+         * With uEspConfigLib_SAVE_NONDEFAULT_ONLY only options whose value differs from its default are stored, plus a hash
+         * of options names and defaults; loading then starts from defaults. On key/value storages default values are erased.
+         * With uEspConfigLib_SAVE_COMPACT files contain only name=value lines, without header nor per-option comments.
+         *
+         * @param flags uEspConfigLib_SAVE_* flags, combined with |. 0 to store every option (default)
+         */
+        void setSaveFlags(const uint8_t);
+
+        /**
+         * \brief Checks if main config file, or a section loaded after it, was saved with different options or defaults
+         *
+         * Only known when saved with uEspConfigLib_SAVE_NONDEFAULT_ONLY.
+         *
+         * @return True if options names or defaults changed since it was saved
+         */
+        bool isSchemaChanged();
+
+        /**
+         * \brief Gets last load profiling results
+         *
+         * @return Timings, in microseconds
+         */
+        uEspConfigLibTimings getTimings();
+
+        /**
+         * \brief Prints last load profiling results
+         *
+         * @param output Where to print, i.e.: Serial
+         */
+        void printTimings(Print &);
+
+        /**
+         * \brief Handles a load profiling JSON request
+         *
+         * Responds {"data":{"mount":0,"open":0,"read":0,"parse":0,"set":0,"close":0,"total":0,"bytes":0,"options":0,"formatted":0}}, times in microseconds
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        void handleTimingsJson(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles a load profiling JSON request, on any web server
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleTimingsJson(uEspConfigLibWebRequest *);
+
+        /**
+         * \brief Gets operational metrics
+         *
+         * Loads, saves, web handler responses and WiFi scans are always counted. Heap is calculated on each call.
+         *
+         * @return Metrics
+         */
+        uEspConfigLibMetrics getMetrics();
+
+        /**
+         * \brief Handles a metrics request, in Prometheus text format
+         *
+         * Serves getMetrics() values and bytes written by each storage.
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        void handleMetrics(uEspConfigLib_WebServer *);
+
+        /**
+         * \brief Handles a metrics request, on any web server
+         *
+         * @param request Request adapter (see uEspConfigLibWebRequest)
+         */
+        void handleMetrics(uEspConfigLibWebRequest *);
+
         /**
          * \brief Recreates and overwrites config file to FileSystem with current configurations
          *
-         * @return False on error
+         * When using a key/value storage every option record is written.
+         * Sections with changes are also saved to their own storages.
+         *
+         * @return False on error, or if an incremental save or load is in progress
          */
         bool saveConfigFile();
 
+        /**
+         * \brief Starts an incremental save of config file, to be continued with stepSave()
+         *
+         * Only options without section are saved. Not available with A/B slots (see setBackupStorage).
+         * Changes done while saving are saved again later.
+         *
+         * @return False on error (save or incremental load in progress, A/B slots or storage error)
+         */
+        bool beginSave();
+
+        /**
+         * \brief Continues an incremental save started with beginSave()
+         *
+         * Writes whole options until budget is reached, at least one per call.
+         *
+         * @param budget Bytes to write in this call
+         * @return Progress, from 0 to 99 while saving and 100 when finished. -1 on error or if there is no save in progress
+         */
+        int8_t stepSave(const size_t);
+
+        /**
+         * \brief Checks if an incremental save is in progress
+         *
+         * @return True if saving
+         */
+        bool isSaving();
+
+        /**
+         * \brief Loads (or reloads) a section from its storage
+         *
+         * @param name Name of the section
+         * @return False on error
+         */
+        bool loadSection(const char *);
+
+        /**
+         * \brief Recreates and overwrites a section storage with its current configurations
+         *
+         * @param name Name of the section
+         * @return False on error
+         */
+        bool saveSection(const char *);
+
+        // Write-behind functions
+
+        /**
+         * \brief Enables write-behind mode, saving config file from loop() some time after last change
+         *
+         * When enabled, changes done with set(), clear() or handleSaveConfig() mark configuration as pending to be saved
+         * and loop() saves it once when no more changes arrive during quiet period.
+         *
+         * @param quiet Milliseconds without changes before saving. 0 disables write-behind mode (default)
+         * @param maxDelay Optional. Maximum milliseconds a change can wait to be saved, even if changes keep arriving. 0 for no limit
+         */
+        void setSaveDelay(const unsigned long, const unsigned long = 0);
+
+        /**
+         * \brief Sets write-behind mode to save config file incrementally from loop()
+         *
+         * @param budget Bytes written on each loop() call. 0 saves the whole file at once (default)
+         */
+        void setSaveStep(const size_t);
+
+        /**
+         * \brief Periodic task, saves pending changes in write-behind mode and sends queued server-sent events
+         *
+         * It also continues incremental saves when setSaveStep is used.
+         *
+         * Call it from your sketch loop()
+         */
+        void loop();
+
+        /**
+         * \brief Limits saves done by handleSaveConfig(), handleConfigDownload() and loop(), using a token bucket
+         *
+         * Up to burst saves are allowed at once, and one more each interval. When limit is reached handleSaveConfig()
+         * rejects the request with 429 status or, by default, applies values and defers saving to loop(), joining all
+         * changes in one save. saveConfigFile() and flush() are not limited.
+         *
+         * @param burst Saves allowed at once. 0 disables limit (default)
+         * @param interval Milliseconds to recover one save
+         * @param policy Optional. uEspConfigLib_RATE_DEFER (default) or uEspConfigLib_RATE_REJECT
+         */
+        void setSaveRateLimit(const uint8_t, const unsigned long, const uint8_t = uEspConfigLib_RATE_DEFER);
+
+        /**
+         * \brief Saves pending changes immediately, if any
+         *
+         * @return False on error, or if an incremental save or load is in progress (changes are then saved from loop())
+         */
+        bool flush();
+
+        /**
+         * \brief Checks if there are changes not saved yet
+         *
+         * @return True if there are pending changes
+         */
+        bool isDirty();
+
     private:
         uEspConfigLib(); // 1 arg needed
         void _copyName(uEspConfigLibList *, const char *);
@@ -190,10 +736,103 @@ class uEspConfigLib {
         void _copyValue(uEspConfigLibList *, const char *);
         void _copyValue(uEspConfigLibList *, const String);
         void _copyDescription(uEspConfigLibList *, const char *);
-        void _parseConfigLine(String);
-        void _handleWifiScan(uEspConfigLib_WebServer *, const String);
+        uEspConfigLibList * _addOption(uEspConfigLibSection *, const char *, const char *, const char *, const uint8_t);
+        uEspConfigLibSection * _getSection(const char *, const bool);
+        uEspConfigLibList * _findSlot(const char *);
+        void _ensureLoaded(uEspConfigLibList *);
+        void _ensureAllLoaded();
+        void _retire(char *);
+        void _reclaim();
+        void _lock();
+        void _unlock();
+        uint8_t _readBegin();
+        void _readEnd(const uint8_t);
+        String _readValue(uEspConfigLibList *);
+        bool _loadSection(uEspConfigLibSection *);
+        bool _loadFile(uEspConfigLibFSInterface *, uEspConfigLibSection *, uint32_t * = 0, unsigned int * = 0);
+        bool _saveFile(uEspConfigLibFSInterface *, uEspConfigLibSection *, const uint32_t = 0);
+        bool _loadSlots();
+        bool _saveSlots();
+        bool _readSlotHeader(uEspConfigLibFSInterface *, uint32_t *, uint32_t *, unsigned int *);
+        uint32_t _slotChecksum(const char **, unsigned int *);
+        void _resetSection(uEspConfigLibSection *);
+        bool _isSaved(uEspConfigLibList *, const char *);
+        uint32_t _schemaHash(uEspConfigLibSection *);
+        uEspConfigLibFSInterface * _mainFs();
+        bool _loadStore();
+        char * _kvRead(const char *, char *, const size_t);
+        bool _saveStore();
+        bool _putSchema();
+        bool _putOption(uEspConfigLibList *, const char *);
+        size_t _writeHeader(uEspConfigLibFSInterface *, uEspConfigLibSection *, bool *);
+        size_t _writeOption(uEspConfigLibFSInterface *, uEspConfigLibList *, const char *, bool *);
+        bool _saveDirty();
+        void _updateDirty();
+        bool _takeDirty(bool *);
+        const char * _takeValue(uEspConfigLibList *);
+        void _applyParsed(uEspConfigLibParser *, uEspConfigLibSection *);
+        void _importParsed();
+        void _loadParsed(uEspConfigLibParser *);
+        void _handleWifiScan(uEspConfigLibWebRequest *, const String);
         void handleWifiScanResult();
+        void _markDirty(uEspConfigLibList *);
+        void _sseQueue(uEspConfigLibList *);
+        void _ssePump();
+        bool _sseSend(uEspConfigLibSseClient *, const String);
+        void _sseFlush(uEspConfigLibSseClient *);
+        bool _takeSaveToken();
+        void _countRequest(uEspConfigLibWebRequest *, const unsigned long);
+        void _countSave(const bool, const unsigned long);
+        size_t _heapUsed();
+        void _sendMetric(uEspConfigLibWebRequest *, const char *, const char *, const char *, const uint64_t, const bool = false);
+        void _sendStorageMetric(uEspConfigLibWebRequest *, const char *, const char *, const char *, const size_t);
         uEspConfigLibList *list;
+        uEspConfigLibSection * _sections = 0;
         uEspConfigLibFSInterface * _fs;
+        uEspConfigLibKVInterface * _kv = 0;
+        bool _dirty = false;
+        bool _mainDirty = false;
+        unsigned long _dirtySince = 0;
+        unsigned long _lastChange = 0;
+        unsigned long _saveDelay = 0;
+        unsigned long _saveMaxDelay = 0;
+        bool _concurrent = false;
+        void * _mutex = 0;
+        uint32_t _version = 0;
+        uint32_t _readers[2] = {0, 0};
+        uint32_t _epoch = 0;
+        uEspConfigLibParser * _import = 0;
+        bool _importResult = false;
+        uEspConfigLibFSInterface * _fsB = 0;
+        uint32_t _generation = 0;
+        uint8_t _activeSlot = 0;
+        bool _profiling = false;
+        uEspConfigLibTimings _timings;
+        uint8_t _saveFlags = 0;
+        bool _schemaChanged = false;
+        uEspConfigLibSseClient * _sse = 0;
+        const uEspConfigLibSchema * _schema = 0;
+        uEspConfigLibList ** _schemaSlots = 0;
+        uint16_t _options = 0;
+        bool _saving = false;
+        bool _saveResult = true;
+        bool _saveHeader = false;
+        uEspConfigLibList * _saveCursor = 0;
+        uint16_t _saveDone = 0;
+        uint16_t _saveTotal = 0;
+        size_t _saveStep = 0;
+        uEspConfigLibLoader * _loader = 0;
+        uEspConfigLibList * _loadCursor = 0;
+        bool _loaded = false;
+        uEspConfigLibMetrics _metrics;
+        uint8_t _rateBurst = 0;
+        uint8_t _rateTokens = 0;
+        uint8_t _ratePolicy = uEspConfigLib_RATE_DEFER;
+        unsigned long _rateInterval = 0;
+        unsigned long _rateLast = 0;
+        bool _saveDeferred = false;
+        uEspConfigLibRetired * _retired = 0;
+        uint16_t _retiredCount = 0;
+        uint16_t _retiredSize = 0;
 };
 
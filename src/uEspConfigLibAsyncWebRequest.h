@@ -0,0 +1,77 @@
+/**
+ * \class uEspConfigLibAsyncWebRequest
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - ESPAsyncWebServer request part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Adapts an ESPAsyncWebServer request to uEspConfigLibWebRequest. Header only, as ESPAsyncWebServer is an optional
+ * dependency: include it only on sketches using that library.
+ *
+ *
+ * @file uEspConfigLibAsyncWebRequest.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "uEspConfigLibWebRequest.h"
+
+class uEspConfigLibAsyncWebRequest : public uEspConfigLibWebRequest {
+    public:
+        /**
+         * \brief Constructor
+         *
+         * @param request Request received on AsyncWebServer handler
+         */
+        uEspConfigLibAsyncWebRequest(AsyncWebServerRequest * request) : _request(request), _response(0) {};
+
+        String arg(const char * name) {
+            return _request->arg(name);
+        };
+
+        bool hasArg(const char * name) {
+            return _request->hasArg(name);
+        };
+
+        void begin(const int code, const char * contentType) {
+            _response = _request->beginResponseStream(contentType);
+            _response->setCode(code);
+        };
+
+        using uEspConfigLibWebRequest::sendContent;
+        void sendContent(const char * data) {
+            if (_response != 0) {
+                _sent += _response->print(data);
+            }
+        };
+
+        void sendContent(const char * data, const size_t len) {
+            if (_response != 0) {
+                _sent += _response->write((const uint8_t *) data, len);
+            }
+        };
+
+        void redirect(const char * location) {
+            _request->redirect(location);
+        };
+
+        void end() {
+            if (_response != 0) {
+                _request->send(_response);
+                _response = 0;
+            }
+        };
+
+    private:
+        AsyncWebServerRequest * _request;
+        AsyncResponseStream * _response;
+};
@@ -0,0 +1,309 @@
+/**
+ * \class uEspConfigLibFSCompressed
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Compressed FileSystem interface implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This storage wraps another one, compressing content with a streaming LZ77 using a 255 bytes window.
+ * Compressed data never contains 0 bytes, so it can be stored on any storage, and plain text files are valid
+ * compressed data, so existing configuration files are still read.
+ *
+ *
+ * @file uEspConfigLibFSCompressed.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibFSCompressed.h"
+
+/**
+ * \brief Constructor
+ *
+ * @param backend Storage where compressed content will be stored
+ */
+uEspConfigLibFSCompressed::uEspConfigLibFSCompressed(uEspConfigLibFSInterface * backend) {
+    _backend = backend;
+    _status = uEspConfigLibFS_STATUS_CLOSED;
+    _mountTime = backend->mountTime();
+    _formatted = backend->formatted();
+}
+
+/**
+ * \brief Opens the file for read
+ *
+ * @return False on error
+ */
+bool uEspConfigLibFSCompressed::openToRead() {
+    if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        closeFile();
+    }
+    if (!_backend->openToRead()) {
+        _status = uEspConfigLibFS_STATUS_ERROR;
+        return false;
+    }
+    _historyPosition = 0;
+    _matchLength = 0;
+    _ioPosition = 0;
+    _ioLength = 0;
+    _status = uEspConfigLibFS_STATUS_OPEN_READ;
+    return true;
+}
+
+/**
+ * \brief Opens the file for write
+ *
+ * @return False on error
+ */
+bool uEspConfigLibFSCompressed::openToWrite() {
+    if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        closeFile();
+    }
+    if (!_backend->openToWrite()) {
+        _status = uEspConfigLibFS_STATUS_ERROR;
+        return false;
+    }
+    _windowPosition = 0;
+    _windowLength = 0;
+    _ioLength = 0;
+    _error = false;
+    _lineStart = true;
+    _inComment = false;
+    _status = uEspConfigLibFS_STATUS_OPEN_WRITE;
+    return true;
+}
+
+/**
+ * \brief Reads a whole line from current file
+ *
+ * @param line String pointer where line will be read
+ * @return False on error
+ */
+bool uEspConfigLibFSCompressed::readLine(String *line) {
+    int c;
+    *line = "";
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ) {
+        return false;
+    }
+    c = _readChar();
+    if (c < 0) {
+        return false;
+    }
+    while (c >= 0 && c != '\n') {
+        if (c != '\r') {
+            *line += (char) c;
+        }
+        c = _readChar();
+    }
+    return true;
+}
+
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSCompressed::readLine(char *line, const size_t size) {
+    int c;
+    size_t len = 0;
+    if (size == 0 || _status != uEspConfigLibFS_STATUS_OPEN_READ) {
+        return false;
+    }
+    c = _readChar();
+    if (c < 0) {
+        return false;
+    }
+    while (c >= 0 && c != '\n') {
+        if (c != '\r' && len + 1 < size) {
+            line[len] = (char) c;
+            len++;
+        }
+        c = _readChar();
+    }
+    line[len] = 0;
+    return true;
+}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSCompressed::read(char *data, const size_t size) {
+    size_t len = 0;
+    int c;
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ) {
+        return 0;
+    }
+    while (len < size && (c = _readChar()) >= 0) {
+        data[len] = (char) c;
+        len++;
+    }
+    return len;
+}
+
+/**
+ * \brief Writes content to current file
+ *
+ * Comment lines (starting with #, ; or //) and empty lines are not stored, as compressed content is not edited by hand.
+ *
+ * @param data char array pointer to be written
+ * @return False on error
+ */
+bool uEspConfigLibFSCompressed::write(const char *data) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        return false;
+    }
+    for (; *data != 0; data++) {
+        if (_lineStart && (*data == '#' || *data == ';' || (*data == '/' && data[1] == '/'))) {
+            _inComment = true;
+        }
+        if (*data == '\n' || *data == '\r') {
+            bool skip = _inComment || _lineStart;
+            _inComment = false;
+            _lineStart = true;
+            if (skip) {
+                continue;
+            }
+        } else if (_inComment) {
+            continue;
+        } else {
+            _lineStart = false;
+        }
+        while (_windowLength == uEspConfigLibFSCompressed_WINDOW + uEspConfigLibFSCompressed_MAX_MATCH) { // Lookahead full
+            if (!_encode()) {
+                return false;
+            }
+        }
+        _window[_windowLength] = *data;
+        _windowLength++;
+        _bytesWritten++;
+    }
+    return !_error;
+}
+
+/**
+ * \brief Closes current file
+ *
+ * @return False on error
+ */
+bool uEspConfigLibFSCompressed::closeFile() {
+    bool result = true;
+    if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        while (_windowPosition < _windowLength) {
+            _encode();
+        }
+        if (_ioLength > 0 && !_backend->writeRaw(_io, _ioLength)) {
+            _error = true;
+        }
+        _ioLength = 0;
+        result = !_error;
+    }
+    if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        result = _backend->closeFile() && result;
+    }
+    _status = uEspConfigLibFS_STATUS_CLOSED;
+    return result;
+}
+
+// Encodes one token at current position: a match of 3 or more bytes inside the window, or a literal
+bool uEspConfigLibFSCompressed::_encode() {
+    size_t lookahead = _windowLength - _windowPosition;
+    size_t maxLength = lookahead < uEspConfigLibFSCompressed_MAX_MATCH ? lookahead : uEspConfigLibFSCompressed_MAX_MATCH;
+    size_t bestLength = 0;
+    size_t bestDistance = 0;
+    for (size_t start = 0; start < _windowPosition; start++) {
+        size_t length = 0;
+        while (length < maxLength && _window[start + length] == _window[_windowPosition + length]) {
+            length++;
+        }
+        if (length >= bestLength) { // Nearest on ties
+            bestLength = length;
+            bestDistance = _windowPosition - start;
+        }
+    }
+    if (bestLength >= 3) {
+        _emit(uEspConfigLibFSCompressed_MARK);
+        _emit((char) bestLength);
+        _emit((char) bestDistance);
+        _windowPosition += bestLength;
+    } else {
+        if (_window[_windowPosition] == uEspConfigLibFSCompressed_MARK) {
+            _emit(uEspConfigLibFSCompressed_MARK);
+        }
+        _emit(_window[_windowPosition]);
+        _windowPosition++;
+    }
+    if (_windowPosition > uEspConfigLibFSCompressed_WINDOW) { // Drop bytes out of window
+        size_t drop = _windowPosition - uEspConfigLibFSCompressed_WINDOW;
+        memmove(_window, _window + drop, _windowLength - drop);
+        _windowPosition -= drop;
+        _windowLength -= drop;
+        uEspConfigLibYield::step(drop);
+    }
+    return !_error;
+}
+
+bool uEspConfigLibFSCompressed::_emit(const char c) {
+    _io[_ioLength] = c;
+    _ioLength++;
+    if (_ioLength == uEspConfigLibFSCompressed_IO_SIZE) {
+        if (!_backend->writeRaw(_io, _ioLength)) {
+            _error = true;
+        }
+        _ioLength = 0;
+    }
+    return !_error;
+}
+
+int uEspConfigLibFSCompressed::_readRaw() {
+    if (_ioPosition == _ioLength) {
+        _ioLength = _backend->read(_io, uEspConfigLibFSCompressed_IO_SIZE);
+        _ioPosition = 0;
+        if (_ioLength == 0) {
+            return -1;
+        }
+    }
+    _ioPosition++;
+    return (uint8_t) _io[_ioPosition - 1];
+}
+
+int uEspConfigLibFSCompressed::_readChar() {
+    int c = -1;
+    if (_matchLength == 0) {
+        c = _readRaw();
+        if (c == uEspConfigLibFSCompressed_MARK) {
+            c = _readRaw();
+            if (c > uEspConfigLibFSCompressed_MARK) { // Match: length and distance
+                int distance = _readRaw();
+                if (distance <= 0) {
+                    return -1;
+                }
+                _matchLength = c;
+                _matchDistance = distance;
+            }
+        }
+        if (c < 0) {
+            return -1;
+        }
+    }
+    if (_matchLength > 0) {
+        c = (uint8_t) _window[(uint8_t) (_historyPosition - _matchDistance)];
+        _matchLength--;
+    }
+    _window[_historyPosition] = (char) c;
+    _historyPosition++;
+    return c;
+}
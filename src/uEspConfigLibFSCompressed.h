@@ -0,0 +1,144 @@
+/**
+ * \class uEspConfigLibFSCompressed
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Compressed FileSystem interface implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This storage wraps another one, compressing content with a streaming LZ77 using a 255 bytes window.
+ * Compressed data never contains 0 bytes, so it can be stored on any storage, and plain text files are valid
+ * compressed data, so existing configuration files are still read.
+ *
+ *
+ * @file uEspConfigLibFSCompressed.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLibFSInterface.h"
+
+/**
+ * \brief Window size, in bytes. Fixed, as match distance is stored in one byte
+ */
+#define uEspConfigLibFSCompressed_WINDOW 255
+
+/**
+ * \brief Longest match, in bytes (3 to 255). Longer matches compress better but need more RAM and time
+ */
+#ifndef uEspConfigLibFSCompressed_MAX_MATCH
+    #define uEspConfigLibFSCompressed_MAX_MATCH 64
+#endif
+
+/**
+ * \brief Size of the buffer used to read from and write to the wrapped storage
+ */
+#define uEspConfigLibFSCompressed_IO_SIZE 32
+
+/**
+ * \brief Token mark: followed by length and distance bytes, or by another mark for a literal mark byte
+ */
+#define uEspConfigLibFSCompressed_MARK 0x01
+
+class uEspConfigLibFSCompressed : public uEspConfigLibFSInterface {
+    public:
+        /**
+         * \brief Constructor
+         *
+         * @param backend Storage where compressed content will be stored
+         */
+        uEspConfigLibFSCompressed(uEspConfigLibFSInterface *);
+
+        /**
+         * \brief Opens the file for read
+         *
+         * @return False on error
+         */
+        bool openToRead();
+
+        /**
+         * \brief Opens the file for write
+         *
+         * @return False on error
+         */
+        bool openToWrite();
+
+        /**
+         * \brief Reads a whole line from current file
+         *
+         * @param line String pointer where line will be read
+         * @return False on error
+         */
+        bool readLine(String *);
+
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
+        /**
+         * \brief Writes content to current file
+         *
+         * Comment lines (starting with #, ; or //) and empty lines are not stored, as compressed content is not edited by hand.
+         *
+         * @param data char array pointer to be written
+         * @return False on error
+         */
+        bool write(const char *);
+
+        /**
+         * \brief Closes current file
+         *
+         * @return False on error
+         */
+        bool closeFile();
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "compressed"
+         */
+        const char * typeName() { return "compressed"; }
+
+    private:
+        int _readRaw();
+        int _readChar();
+        bool _encode();
+        bool _emit(const char);
+        uEspConfigLibFSInterface * _backend;
+        // Writing: window history plus lookahead. Reading: last 256 output bytes
+        char _window[uEspConfigLibFSCompressed_WINDOW + uEspConfigLibFSCompressed_MAX_MATCH];
+        size_t _windowPosition = 0;
+        size_t _windowLength = 0;
+        uint8_t _historyPosition = 0;
+        uint8_t _matchLength = 0;
+        uint8_t _matchDistance = 0;
+        char _io[uEspConfigLibFSCompressed_IO_SIZE];
+        uint8_t _ioPosition = 0;
+        uint8_t _ioLength = 0;
+        bool _error = false;
+        bool _lineStart = true;
+        bool _inComment = false;
+};
@@ -29,9 +29,7 @@
  * @param init Set to true if you want to initialize and format (if needed) the filesystem
  * @param address EEPROM I2C address
  */
-uEspConfigLibFSEEPROM::uEspConfigLibFSEEPROM(const bool init, const uint8_t address) {
-    uEspConfigLibFSEEPROM("", init, address);
-}
+uEspConfigLibFSEEPROM::uEspConfigLibFSEEPROM(const bool init, const uint8_t address) : uEspConfigLibFSEEPROM("", init, address) {}
 	
 /**
  * \brief Constructor
@@ -41,7 +39,9 @@ uEspConfigLibFSEEPROM::uEspConfigLibFSEEPROM(const bool init, const uint8_t addr
  * @param address EEPROM I2C address
  */
 uEspConfigLibFSEEPROM::uEspConfigLibFSEEPROM(const char *path, const bool init, const uint8_t address) {
+    unsigned long start = uEspConfigLib_micros();
     _eeprom = new uEEPROMLib(address);
+    _mountTime = uEspConfigLib_micros() - start;
     _status = uEspConfigLibFS_STATUS_CLOSED;
 }
 
@@ -54,7 +54,7 @@ bool uEspConfigLibFSEEPROM::openToRead() {
     if (_status == uEspConfigLibFS_STATUS_FATAL) {
         return false;
     }
-    _position = 0;
+    _position = _startAddress;
     _bufferPosition = 0;
     _status = uEspConfigLibFS_STATUS_OPEN_READ;
     
@@ -71,7 +71,7 @@ bool uEspConfigLibFSEEPROM::openToWrite() {
     if (_status == uEspConfigLibFS_STATUS_FATAL) {
         return false;
     }
-    _position = 0;
+    _position = _startAddress;
     _bufferPosition = 0;
     _saveInComment = false;
     _saveLineStart = true;
@@ -99,11 +99,11 @@ bool uEspConfigLibFSEEPROM::readLine(String *line) {
         if (!_eeprom->eeprom_read(_position, _buffer, uEspConfigLibFSEEPROM_BUFFER_SIZE)) {
             return false;
         }
+        uEspConfigLibYield::step(uEspConfigLibFSEEPROM_BUFFER_SIZE);
         for (unsigned int i = 0; i < uEspConfigLibFSEEPROM_BUFFER_SIZE; i++) {
         actualChar = (char) _buffer[i];
             line->concat(actualChar);
             _position++;
-    		yield();
             if (actualChar == '\0') { // EOF
                 return false;
             }
@@ -115,6 +115,75 @@ bool uEspConfigLibFSEEPROM::readLine(String *line) {
     return false;
 }
 
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSEEPROM::readLine(char *line, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ || size == 0) {
+	    return false;
+    }
+    char actualChar;
+    size_t len = 0;
+
+    // Limit to 50Kb lines, more than expected but at least we add one exit path
+    for (int loop = 0; loop < 400; loop++) {
+        if (!_eeprom->eeprom_read(_position, _buffer, uEspConfigLibFSEEPROM_BUFFER_SIZE)) {
+            return false;
+        }
+        uEspConfigLibYield::step(uEspConfigLibFSEEPROM_BUFFER_SIZE);
+        for (unsigned int i = 0; i < uEspConfigLibFSEEPROM_BUFFER_SIZE; i++) {
+            actualChar = (char) _buffer[i];
+            if (actualChar == '\0') { // EOF, stay on it so next read also ends
+                line[len] = 0;
+                return (len > 0);
+            }
+            _position++;
+            if (actualChar == '\n' || actualChar == '\r') { // EOL
+                line[len] = 0;
+                return true;
+            }
+            if (len + 1 < size) {
+                line[len] = actualChar;
+                len++;
+            }
+        }
+    }
+    line[len] = 0;
+    return false;
+}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSEEPROM::read(char *data, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ) {
+	    return 0;
+    }
+    size_t len = (size > uEspConfigLibFSEEPROM_BUFFER_SIZE ? uEspConfigLibFSEEPROM_BUFFER_SIZE : size);
+    if (_position - _startAddress + len > uEspConfigLibFSEEPROM_MAX_SIZE) { // No EOF mark found (i.e.: blank EEPROM)
+        len = uEspConfigLibFSEEPROM_MAX_SIZE - (_position - _startAddress);
+    }
+    if (len == 0 || !_eeprom->eeprom_read(_position, (byte *) data, len)) {
+        return 0;
+    }
+    char * eof = (char *) memchr(data, 0, len);
+    if (eof != 0) { // Stay on EOF so next read also ends
+        len = eof - data;
+    }
+    _position += len;
+    return len;
+}
+
 /**
  * \brief Writes content to current file
  *
@@ -127,7 +196,7 @@ bool uEspConfigLibFSEEPROM::write(const char *data) {
     }
     int len = strlen(data);
     for (int i = 0; i < len; i++) {
-        if (_bufferPosition >= uEspConfigLibFSEEPROM_BUFFER_SIZE) {
+        if (_bufferPosition >= _pageSize - (_position % _pageSize)) {
             if (!_writeFlush()) {
                 return false;
             }
@@ -157,27 +226,72 @@ bool uEspConfigLibFSEEPROM::write(const char *data) {
 }
 
 
+/**
+ * \brief Writes binary-safe content to current file, without comment filtering
+ *
+ * @param data Data to be written, 0 bytes are skipped
+ * @param len Data length
+ * @return False on error
+ */
+bool uEspConfigLibFSEEPROM::writeRaw(const char *data, const size_t len) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE) {
+	    return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (_bufferPosition >= _pageSize - (_position % _pageSize)) {
+            if (!_writeFlush()) {
+                return false;
+            }
+        }
+        if (data[i] == '\0') { // Reserved as end of file mark
+            continue;
+        }
+        _buffer[_bufferPosition] = data[i];
+        _bufferPosition++;
+    }
+	return true;
+}
+
 /**
  * \brief Writes buffer content to EEPROM
  *
+ * Buffer is filled up to the end of current page, so each flush writes at most one page.
+ *
  * @return False on error
  */
 bool uEspConfigLibFSEEPROM::_writeFlush() {
-    unsigned int size = _bufferPosition;
-    
     if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE || _bufferPosition == 0) {
         return false;
     }
-    if(_bufferPosition < uEspConfigLibFSEEPROM_BUFFER_SIZE) {
-        _buffer[_bufferPosition] = 0; // Add EOF
-        size++;
-    }
-    bool ret = _eeprom->eeprom_write(_position, (void *) _buffer, size);
+    bool ret = _writePage(_bufferPosition);
     _position += _bufferPosition;
     _bufferPosition = 0;
     return ret;
 }
 
+/**
+ * \brief Writes first bytes of buffer to EEPROM at current position, skipping it if already stored
+ *
+ * Only bytes actually written are counted on bytesWritten().
+ *
+ * @param size Number of bytes to write
+ * @return False on error
+ */
+bool uEspConfigLibFSEEPROM::_writePage(const unsigned int size) {
+    uEspConfigLibYield::step(size);
+    if (_compare) {
+        byte stored[uEspConfigLibFSEEPROM_BUFFER_SIZE];
+        if (_eeprom->eeprom_read(_position, stored, size) && memcmp(stored, _buffer, size) == 0) {
+            return true;
+        }
+    }
+    if (!_eeprom->eeprom_write(_position, (void *) _buffer, size)) {
+        return false;
+    }
+    _bytesWritten += size;
+    return true;
+}
+
 
 
 /**
@@ -186,14 +300,57 @@ bool uEspConfigLibFSEEPROM::_writeFlush() {
  * @return False on error
  */
 bool uEspConfigLibFSEEPROM::closeFile() {
-    if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE && _bufferPosition > 0) {
+    if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        bool ret = true;
+        if (_bufferPosition >= _pageSize - (_position % _pageSize)) {
+            ret = _writeFlush();
+        }
+        _buffer[_bufferPosition] = 0; // Add EOF
+        _bufferPosition++;
+        ret = _writeFlush() && ret;
         _status = uEspConfigLibFS_STATUS_CLOSED;
-        return _writeFlush();
+        return ret;
     }
-    if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {    
+    if (_status == uEspConfigLibFS_STATUS_OPEN_READ) {
         _status = uEspConfigLibFS_STATUS_CLOSED;
         return true;
     }
     return false;
 }
 
+/**
+ * \brief Sets EEPROM chip page size
+ *
+ * Writes are split so they never cross a page boundary. Usual values are 32, 64 or 128.
+ *
+ * @param pageSize Page size in bytes, from 1 to uEspConfigLibFSEEPROM_BUFFER_SIZE
+ */
+void uEspConfigLibFSEEPROM::setPageSize(const uint8_t pageSize) {
+    if (pageSize == 0 || pageSize > uEspConfigLibFSEEPROM_BUFFER_SIZE) {
+        _pageSize = uEspConfigLibFSEEPROM_BUFFER_SIZE;
+    } else {
+        _pageSize = pageSize;
+    }
+}
+
+/**
+ * \brief Enables or disables read-compare-write mode
+ *
+ * When enabled each page is read before writing it and skipped if unchanged, saving write cycles.
+ *
+ * @param compare True to enable (default), false to always write
+ */
+void uEspConfigLibFSEEPROM::setCompareBeforeWrite(const bool compare) {
+    _compare = compare;
+}
+
+/**
+ * \brief Sets EEPROM address where this storage begins
+ *
+ * Lets you use different regions of the same EEPROM for different configuration sections. Regions must not overlap.
+ *
+ * @param address First EEPROM address to be used, 0 by default
+ */
+void uEspConfigLibFSEEPROM::setStartAddress(const unsigned int address) {
+    _startAddress = address;
+}
@@ -25,9 +25,25 @@
 #include "uEEPROMLib.h"
 
 
-class uEspConfigLibFSEEPROM : public uEspConfigLibFSInterface {
+/**
+ * \brief Maximum EEPROM page size supported (also internal write buffer size)
+ */
+#define uEspConfigLibFSEEPROM_BUFFER_SIZE 128
+/**
+ * \brief Maximum configuration size read from EEPROM, used as exit path if EOF mark is missing
+ */
+#ifndef uEspConfigLibFSEEPROM_MAX_SIZE
+    #define uEspConfigLibFSEEPROM_MAX_SIZE 65536
+#endif
+/**
+ * \brief Default EEPROM page size (AT24C32 / AT24C64 chips)
+ */
+#ifndef uEspConfigLibFSEEPROM_PAGE_SIZE
+    #define uEspConfigLibFSEEPROM_PAGE_SIZE 32
+#endif
+
 
-    #define uEspConfigLibFSEEPROM_BUFFER_SIZE 128
+class uEspConfigLibFSEEPROM : public uEspConfigLibFSInterface {
 
     public:
         /**
@@ -69,6 +85,26 @@ class uEspConfigLibFSEEPROM : public uEspConfigLibFSInterface {
          */
         bool readLine(String *);
 
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
         /**
          * \brief Writes content to current file
          *
@@ -77,6 +113,15 @@ class uEspConfigLibFSEEPROM : public uEspConfigLibFSInterface {
          */
         bool write(const char *);
 
+        /**
+         * \brief Writes binary-safe content to current file, without comment filtering
+         *
+         * @param data Data to be written, 0 bytes are skipped
+         * @param len Data length
+         * @return False on error
+         */
+        bool writeRaw(const char *, const size_t);
+
         /**
          * \brief Closes current file
          *
@@ -84,14 +129,51 @@ class uEspConfigLibFSEEPROM : public uEspConfigLibFSInterface {
          */
         bool closeFile();
 
+        /**
+         * \brief Sets EEPROM chip page size
+         *
+         * Writes are split so they never cross a page boundary. Usual values are 32, 64 or 128.
+         *
+         * @param pageSize Page size in bytes, from 1 to uEspConfigLibFSEEPROM_BUFFER_SIZE
+         */
+        void setPageSize(const uint8_t);
+
+        /**
+         * \brief Enables or disables read-compare-write mode
+         *
+         * When enabled each page is read before writing it and skipped if unchanged, saving write cycles.
+         *
+         * @param compare True to enable (default), false to always write
+         */
+        void setCompareBeforeWrite(const bool);
+
+        /**
+         * \brief Sets EEPROM address where this storage begins
+         *
+         * Lets you use different regions of the same EEPROM for different configuration sections. Regions must not overlap.
+         *
+         * @param address First EEPROM address to be used, 0 by default
+         */
+        void setStartAddress(const unsigned int);
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "eeprom"
+         */
+        const char * typeName() { return "eeprom"; }
+
     private:
         bool _writeFlush();
+        bool _writePage(const unsigned int);
         byte _buffer[uEspConfigLibFSEEPROM_BUFFER_SIZE];
         unsigned int _position = 0;
+        unsigned int _startAddress = 0;
         unsigned int _bufferPosition = 0;
-        uint8_t _status;
         bool _saveInComment = false;
         bool _saveLineStart = true;
+        uint8_t _pageSize = uEspConfigLibFSEEPROM_PAGE_SIZE;
+        bool _compare = true;
         uEEPROMLib * _eeprom;
     };
 
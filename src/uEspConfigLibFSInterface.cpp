@@ -0,0 +1,178 @@
+/**
+ * \class uEspConfigLibFSInterface
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - FileSystem interface part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ * 
+ * Currently storage classes are: SD-card, LittleFS, SPIFFS, EEPROM and none (values are lost after restart).
+ *
+ *
+ * @file uEspConfigLibFSInterface.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.1.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibFSInterface.h"
+
+
+/**
+ * \brief Destructor, frees write buffer and path
+ *
+ * Storages using write buffer close their file on their own destructor, so pending content is written.
+ */
+uEspConfigLibFSInterface::~uEspConfigLibFSInterface() {
+    if (_writeBuffer != 0) {
+        free(_writeBuffer);
+        _writeBuffer = 0;
+    }
+    if (_path != 0) {
+        free(_path);
+        _path = 0;
+    }
+}
+
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSInterface::readLine(char *line, const size_t size) {
+    String buffer;
+    if (size == 0 || !readLine(&buffer)) {
+        return false;
+    }
+    strncpy(line, buffer.c_str(), size - 1);
+    line[size - 1] = 0;
+    return true;
+}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * Storages without raw read support are read line by line; the part of a line that does not fit is returned on next calls.
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSInterface::read(char *data, const size_t size) {
+    // Line by line fallback for storages without raw read support
+    if (size == 0) {
+        return 0;
+    }
+    if (_readAheadPosition >= _readAhead.length()) {
+        _readAheadPosition = 0;
+        if (!readLine(&_readAhead)) {
+            discardReadAhead();
+            return 0;
+        }
+        _readAhead += '\n';
+    }
+    size_t len = _readAhead.length() - _readAheadPosition;
+    if (len > size) {
+        len = size;
+    }
+    memcpy(data, _readAhead.c_str() + _readAheadPosition, len);
+    _readAheadPosition += len;
+    return len;
+}
+
+/**
+ * \brief Discards the line kept by read() for storages without raw read support
+ *
+ * Needed only when a file is closed before reading it to the end.
+ */
+void uEspConfigLibFSInterface::discardReadAhead() {
+    _readAhead = String(); // Frees long lines
+    _readAheadPosition = 0;
+}
+
+/**
+ * \brief Writes binary-safe content to current file, without any filtering
+ *
+ * Used by storage decorators (i.e.: compression). Data must not contain 0 bytes.
+ *
+ * @param data Data to be written
+ * @param len Data length
+ * @return False on error
+ */
+bool uEspConfigLibFSInterface::writeRaw(const char *data, const size_t len) {
+    char chunk[33];
+    for (size_t i = 0; i < len; i += 32) {
+        size_t size = (len - i < 32) ? len - i : 32;
+        memcpy(chunk, data + i, size);
+        chunk[size] = 0;
+        if (!write(chunk)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Sets write buffer size
+ *
+ * Storages using it join small writes and send them to the file only when buffer is full or file is closed.
+ *
+ * @param size Buffer size in bytes. 0 to disable buffering
+ */
+void uEspConfigLibFSInterface::setWriteBufferSize(const size_t size) {
+    _bufferedFlush();
+    if (_writeBuffer != 0) {
+        free(_writeBuffer);
+        _writeBuffer = 0;
+    }
+    _writeBufferSize = size;
+}
+
+/**
+ * \brief Adds content to write buffer, flushing it to the file when full
+ *
+ * @param data char array pointer to be written
+ * @return False on error
+ */
+bool uEspConfigLibFSInterface::_bufferedWrite(const char *data) {
+    size_t len = strlen(data);
+    if (len == 0) {
+        return true;
+    }
+    _bytesWritten += len;
+    if (_writeBuffer == 0 && _writeBufferSize > 0) {
+        _writeBuffer = (uint8_t *) malloc(_writeBufferSize);
+        _writeBufferPosition = 0;
+    }
+    if (_writeBuffer == 0 || len >= _writeBufferSize) { // No buffer or too big to be buffered, write directly
+        return _bufferedFlush() && _rawWrite((const uint8_t *) data, len) == len;
+    }
+    if (_writeBufferPosition + len > _writeBufferSize && !_bufferedFlush()) {
+        return false;
+    }
+    memcpy(_writeBuffer + _writeBufferPosition, data, len);
+    _writeBufferPosition += len;
+    return true;
+}
+
+/**
+ * \brief Writes pending buffer content to the file
+ *
+ * @return False on error
+ */
+bool uEspConfigLibFSInterface::_bufferedFlush() {
+    if (_writeBuffer == 0 || _writeBufferPosition == 0) {
+        return true;
+    }
+    size_t size = _writeBufferPosition;
+    _writeBufferPosition = 0;
+    return (_rawWrite(_writeBuffer, size) == size);
+}
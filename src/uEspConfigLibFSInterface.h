@@ -21,6 +21,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "uEspConfigLibYield.h"
 
 /**
  * \brief FileSystem class status: UNITIALIZED
@@ -46,9 +47,29 @@
  * \brief FileSystem class status: FATAL ERROR
  */
 #define uEspConfigLibFS_STATUS_FATAL 10
+/**
+ * \brief Default write buffer size, in bytes, for file based storages
+ */
+#ifndef uEspConfigLibFS_WRITE_BUFFER_SIZE
+    #define uEspConfigLibFS_WRITE_BUFFER_SIZE 256
+#endif
+
+/**
+ * \brief Clock used for profiling, in microseconds. Define it before including the library to use another one (i.e.: on host tests)
+ */
+#ifndef uEspConfigLib_micros
+    #define uEspConfigLib_micros() micros()
+#endif
 
 class uEspConfigLibFSInterface {
     public:
+        /**
+         * \brief Destructor, frees write buffer and path
+         *
+         * Storages using write buffer close their file on their own destructor, so pending content is written.
+         */
+        virtual ~uEspConfigLibFSInterface();
+
         // Regular usage functions
         /**
          * \brief Opens the file for read
@@ -72,6 +93,35 @@ class uEspConfigLibFSInterface {
          */
         virtual bool readLine(String *) { return false; };
 
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        virtual bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * Storages without raw read support are read line by line; the part of a line that does not fit is returned on next calls.
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        virtual size_t read(char *, const size_t);
+
+        /**
+         * \brief Discards the line kept by read() for storages without raw read support
+         *
+         * Needed only when a file is closed before reading it to the end.
+         */
+        void discardReadAhead();
+
         /**
          * \brief Writes content to current file
          *
@@ -80,6 +130,17 @@ class uEspConfigLibFSInterface {
          */
         virtual bool write(const char *) { return false; };
 
+        /**
+         * \brief Writes binary-safe content to current file, without any filtering
+         *
+         * Used by storage decorators (i.e.: compression). Data must not contain 0 bytes.
+         *
+         * @param data Data to be written
+         * @param len Data length
+         * @return False on error
+         */
+        virtual bool writeRaw(const char *, const size_t);
+
         /**
          * \brief Closes current file
          *
@@ -94,8 +155,63 @@ class uEspConfigLibFSInterface {
          */
         uint8_t status() { return _status; }
 
-    private:
-        uint8_t _status;
+        /**
+         * \brief Sets write buffer size
+         *
+         * Storages using it join small writes and send them to the file only when buffer is full or file is closed.
+         *
+         * @param size Buffer size in bytes. 0 to disable buffering
+         */
+        void setWriteBufferSize(const size_t);
+
+        /**
+         * \brief Returns time spent initializing the filesystem on constructor, including format if needed
+         *
+         * @return Microseconds, 0 if filesystem was not initialized by this object
+         */
+        unsigned long mountTime() { return _mountTime; }
+
+        /**
+         * \brief Returns if filesystem had to be formatted on constructor
+         *
+         * @return True if formatted
+         */
+        bool formatted() { return _formatted; }
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return Type name, i.e.: "littlefs"
+         */
+        virtual const char * typeName() { return "custom"; }
+
+        /**
+         * \brief Returns bytes written since object creation
+         *
+         * @return Bytes
+         */
+        size_t bytesWritten() { return _bytesWritten; }
+
+        /**
+         * \brief Returns heap used by this object buffers
+         *
+         * @return Bytes
+         */
+        virtual size_t heapUsed() { return _writeBuffer != 0 ? _writeBufferSize : 0; }
+
+    protected:
+        bool _bufferedWrite(const char *);
+        bool _bufferedFlush();
+        virtual size_t _rawWrite(const uint8_t *, const size_t) { return 0; };
+        uint8_t * _writeBuffer = 0;
+        size_t _writeBufferSize = uEspConfigLibFS_WRITE_BUFFER_SIZE;
+        size_t _writeBufferPosition = 0;
+        unsigned long _mountTime = 0;
+        bool _formatted = false;
+        size_t _bytesWritten = 0;
+        uint8_t _status = uEspConfigLibFS_STATUS_NOINIT;
         char * _path = 0;
+        String _readAhead;
+        size_t _readAheadPosition = 0;
 };
 
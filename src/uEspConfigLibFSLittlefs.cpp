@@ -21,6 +21,7 @@
 #include <Arduino.h>
 #include "uEspConfigLibFSInterface.h"
 #include "uEspConfigLibFSLittlefs.h"
+#include "uEspConfigLibFSMount.h"
 
 
 /**
@@ -28,9 +29,7 @@
  *
  * @param init Set to true if you want to initialize and format (if needed) the filesystem
  */
-uEspConfigLibFSLittlefs::uEspConfigLibFSLittlefs(const bool init) {
-    uEspConfigLibFSLittlefs("/uEspConfig.ini", init);
-}
+uEspConfigLibFSLittlefs::uEspConfigLibFSLittlefs(const bool init) : uEspConfigLibFSLittlefs("/uEspConfig.ini", init) {}
 	
 /**
  * \brief Constructor
@@ -45,25 +44,27 @@ uEspConfigLibFSLittlefs::uEspConfigLibFSLittlefs(const char *path, const bool in
     _path = (char *) malloc(sizeof(char) * (strlen(path) + 1));
     strcpy(_path, path);
     
-    // Init FS if requested
+    // Init FS if requested; shared, so it is mounted only once
 	if (init) {
-        _status = uEspConfigLibFS_STATUS_NOINIT;
-        bool correct = LittleFS.begin(uEspConfigLibFSLittlefs_begin_param);
-		yield();
-	    if (!correct) {
-		    LittleFS.format();
-    		yield();
-		    correct = LittleFS.begin();
-    		yield();
-	    }
-	    if (correct) {
+        bool mounted = uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_LITTLEFS);
+        unsigned long start = uEspConfigLib_micros();
+	    if (uEspConfigLibFSMount::mount(uEspConfigLibFSMount_LITTLEFS)) {
 	        _status = uEspConfigLibFS_STATUS_CLOSED;
 	    } else {
 	        _status = uEspConfigLibFS_STATUS_FATAL;
         }
+        _mountTime = uEspConfigLib_micros() - start;
+        _formatted = !mounted && uEspConfigLibFSMount::formatted(uEspConfigLibFSMount_LITTLEFS);
 	}
 }
 
+/**
+ * \brief Destructor, closes current file writing pending buffer content
+ */
+uEspConfigLibFSLittlefs::~uEspConfigLibFSLittlefs() {
+    closeFile();
+}
+
 /**
  * \brief Opens the file for read
  *
@@ -75,6 +76,9 @@ bool uEspConfigLibFSLittlefs::openToRead() {
     }
 
     if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+            _bufferedFlush();
+        }
 	    _dataFile.close();
         _status = uEspConfigLibFS_STATUS_CLOSED;
 		yield();
@@ -101,6 +105,9 @@ bool uEspConfigLibFSLittlefs::openToWrite() {
     }
 
     if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+            _bufferedFlush();
+        }
 	    _dataFile.close();
         _status = uEspConfigLibFS_STATUS_CLOSED;
 		yield();
@@ -111,6 +118,7 @@ bool uEspConfigLibFSLittlefs::openToWrite() {
         _status = uEspConfigLibFS_STATUS_ERROR;
         return false;
     }
+    _writeBufferPosition = 0;
     _status = uEspConfigLibFS_STATUS_OPEN_WRITE;
 	return true;
 }
@@ -127,14 +135,56 @@ bool uEspConfigLibFSLittlefs::readLine(String *line) {
 	    return false;
     }
 	if (_dataFile.available()) {    
-		yield();
 	    *line = _dataFile.readStringUntil('\n');
-		yield();
+        uEspConfigLibYield::step(line->length());
         return true;
     }
     return false;
 }
 
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSLittlefs::readLine(char *line, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ || size == 0) {
+	    return false;
+    }
+	if (!_dataFile.available()) {
+        return false;
+    }
+    size_t len = 0;
+    int actualChar;
+    while ((actualChar = _dataFile.read()) >= 0 && actualChar != '\n') {
+        if (len + 1 < size) {
+            line[len] = (char) actualChar;
+            len++;
+        }
+    }
+    line[len] = 0;
+    uEspConfigLibYield::step(len);
+    return true;
+}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSLittlefs::read(char *data, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ) {
+	    return 0;
+    }
+    return _dataFile.read((uint8_t *) data, size);
+}
+
 /**
  * \brief Writes content to current file
  *
@@ -145,7 +195,18 @@ bool uEspConfigLibFSLittlefs::write(const char *data) {
     if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE) {
 	    return false;
     }
-	return (uEspConfigLibFSLittlefs_writeCasted(data) > 0);
+	return _bufferedWrite(data);
+}
+
+/**
+ * \brief Writes raw content to current file, used by write buffer
+ *
+ * @param data Bytes to be written
+ * @param len Number of bytes
+ * @return Number of bytes written
+ */
+size_t uEspConfigLibFSLittlefs::_rawWrite(const uint8_t *data, const size_t len) {
+    return _dataFile.write(data, len);
 }
 
 /**
@@ -155,10 +216,14 @@ bool uEspConfigLibFSLittlefs::write(const char *data) {
  */
 bool uEspConfigLibFSLittlefs::closeFile() {
     if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        bool ret = true;
+        if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+            ret = _bufferedFlush();
+        }
 	    _dataFile.close();
         _status = uEspConfigLibFS_STATUS_CLOSED;
 		yield();
-        return true;
+        return ret;
     }
     return false;
 }
@@ -26,10 +26,8 @@
 #include "LittleFS.h"
 
 #ifdef ARDUINO_ARCH_ESP32
-    #define uEspConfigLibFSLittlefs_writeCasted(data) _dataFile.write((uint8_t *) data, strlen(data))
     #define uEspConfigLibFSLittlefs_begin_param true
 #else
-    #define uEspConfigLibFSLittlefs_writeCasted(data) _dataFile.write(data, strlen(data))
     #define uEspConfigLibFSLittlefs_begin_param
 #endif
 
@@ -51,6 +49,11 @@ class uEspConfigLibFSLittlefs : public uEspConfigLibFSInterface {
          */
         uEspConfigLibFSLittlefs(const char*, const bool=false);
 
+        /**
+         * \brief Destructor, closes current file writing pending buffer content
+         */
+        ~uEspConfigLibFSLittlefs();
+
         /**
          * \brief Opens the file for read
          *
@@ -73,6 +76,26 @@ class uEspConfigLibFSLittlefs : public uEspConfigLibFSInterface {
          */
         bool readLine(String *);
 
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
         /**
          * \brief Writes content to current file
          *
@@ -88,9 +111,17 @@ class uEspConfigLibFSLittlefs : public uEspConfigLibFSInterface {
          */
         bool closeFile();
 
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "littlefs"
+         */
+        const char * typeName() { return "littlefs"; }
+
+    protected:
+        size_t _rawWrite(const uint8_t *, const size_t);
+
     private:
-        uint8_t _status;
-        char * _path = 0;
     	fs::File _dataFile;
 };
 
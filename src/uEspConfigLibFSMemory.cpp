@@ -0,0 +1,290 @@
+/**
+ * \class uEspConfigLibFSMemory
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - RAM FileSystem interface implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ * 
+ * Currently storage classes are: SD-card, LittleFS, SPIFFS, EEPROM, RAM and none (values are lost after restart).
+ *
+ *
+ * @file uEspConfigLibFSMemory.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.1.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibFSInterface.h"
+#include "uEspConfigLibFSMemory.h"
+
+
+/**
+ * \brief Constructor, heap buffer that grows as needed
+ *
+ * @param capacity Optional. Initial buffer size in bytes
+ */
+uEspConfigLibFSMemory::uEspConfigLibFSMemory(const size_t capacity) {
+    _status = uEspConfigLibFS_STATUS_CLOSED;
+    if (capacity > 0 && !_reserve(capacity)) {
+        _status = uEspConfigLibFS_STATUS_FATAL;
+    }
+}
+
+/**
+ * \brief Constructor, fixed caller-provided memory region (i.e.: RTC memory)
+ *
+ * Region content is kept as it is, so a previously saved configuration can be read again.
+ *
+ * @param region Memory region to be used
+ * @param size Region size in bytes
+ */
+uEspConfigLibFSMemory::uEspConfigLibFSMemory(char *region, const size_t size) {
+    _data = region;
+    _capacity = size;
+    _external = true;
+    _status = uEspConfigLibFS_STATUS_CLOSED;
+    if (region == 0 || size <= uEspConfigLibFSMemory_MAGIC_SIZE) {
+        _status = uEspConfigLibFS_STATUS_FATAL;
+        return;
+    }
+    _validate();
+}
+
+/**
+ * \brief Destructor
+ */
+uEspConfigLibFSMemory::~uEspConfigLibFSMemory() {
+    if (!_external && _data != 0) {
+        free(_data);
+    }
+}
+
+/**
+ * \brief Checks if memory contains a valid image and updates its length
+ *
+ * @return False if there is no valid content
+ */
+bool uEspConfigLibFSMemory::_validate() {
+    _length = 0;
+    if (_data == 0 || _capacity <= uEspConfigLibFSMemory_MAGIC_SIZE || memcmp(_data, uEspConfigLibFSMemory_MAGIC, uEspConfigLibFSMemory_MAGIC_SIZE) != 0) {
+        return false;
+    }
+    char * text = _data + uEspConfigLibFSMemory_MAGIC_SIZE;
+    size_t max = _capacity - uEspConfigLibFSMemory_MAGIC_SIZE;
+    char * end = (char *) memchr(text, 0, max);
+    if (end == 0) { // No terminator, corrupted
+        return false;
+    }
+    _length = end - text;
+    return true;
+}
+
+/**
+ * \brief Ensures buffer can hold given total size, growing it if possible
+ *
+ * @param size Needed size in bytes, including mark and string terminator
+ * @return False if there is no room
+ */
+bool uEspConfigLibFSMemory::_reserve(const size_t size) {
+    if (size <= _capacity) {
+        return true;
+    }
+    if (_external) {
+        return false;
+    }
+    size_t capacity = _capacity * 2;
+    if (capacity < size) {
+        capacity = size;
+    }
+    if (capacity < 64) {
+        capacity = 64;
+    }
+    char * data = (char *) realloc(_data, capacity);
+    if (data == 0) {
+        return false;
+    }
+    _data = data;
+    _capacity = capacity;
+    return true;
+}
+
+/**
+ * \brief Opens the file for read
+ *
+ * @return False on error or if there is no valid content
+ */
+bool uEspConfigLibFSMemory::openToRead() {
+    if (_status == uEspConfigLibFS_STATUS_FATAL) {
+        return false;
+    }
+    if (!_validate()) {
+        _status = uEspConfigLibFS_STATUS_CLOSED;
+        return false;
+    }
+    _position = 0;
+    _status = uEspConfigLibFS_STATUS_OPEN_READ;
+	return true;
+}
+
+/**
+ * \brief Opens the file for write
+ *
+ * @return False on error
+ */
+bool uEspConfigLibFSMemory::openToWrite() {
+    if (_status == uEspConfigLibFS_STATUS_FATAL) {
+        return false;
+    }
+    if (!_reserve(uEspConfigLibFSMemory_MAGIC_SIZE + 1)) {
+        _status = uEspConfigLibFS_STATUS_ERROR;
+        return false;
+    }
+    memcpy(_data, uEspConfigLibFSMemory_MAGIC, uEspConfigLibFSMemory_MAGIC_SIZE);
+    _data[uEspConfigLibFSMemory_MAGIC_SIZE] = 0;
+    _length = 0;
+    _status = uEspConfigLibFS_STATUS_OPEN_WRITE;
+	return true;
+}
+
+/**
+ * \brief Reads a whole line from current file
+ *
+ * @param line String pointer where line will be read
+ * @return False on error
+ */
+bool uEspConfigLibFSMemory::readLine(String *line) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ || _position >= _length) {
+	    return false;
+    }
+    const char * text = _data + uEspConfigLibFSMemory_MAGIC_SIZE;
+    line->remove(0);
+    while (_position < _length && text[_position] != '\n') {
+        line->concat(text[_position]);
+        _position++;
+    }
+    _position++; // Skip EOL
+    return true;
+}
+
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSMemory::readLine(char *line, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ || size == 0 || _position >= _length) {
+	    return false;
+    }
+    const char * start = _data + uEspConfigLibFSMemory_MAGIC_SIZE + _position;
+    const char * eol = (const char *) memchr(start, '\n', _length - _position);
+    size_t len = (eol == 0 ? _length - _position : eol - start);
+    _position += len + 1;
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(line, start, len);
+    line[len] = 0;
+    return true;
+}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSMemory::read(char *data, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ || _position >= _length) {
+	    return 0;
+    }
+    size_t len = _length - _position;
+    if (len > size) {
+        len = size;
+    }
+    memcpy(data, _data + uEspConfigLibFSMemory_MAGIC_SIZE + _position, len);
+    _position += len;
+    return len;
+}
+
+/**
+ * \brief Writes content to current file
+ *
+ * @param data char array pointer to be written
+ * @return False on error (i.e.: fixed region is full)
+ */
+bool uEspConfigLibFSMemory::write(const char *data) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE) {
+	    return false;
+    }
+    size_t len = strlen(data);
+    if (!_reserve(uEspConfigLibFSMemory_MAGIC_SIZE + _length + len + 1)) {
+        return false;
+    }
+    char * text = _data + uEspConfigLibFSMemory_MAGIC_SIZE;
+    memcpy(text + _length, data, len);
+    _length += len;
+    _bytesWritten += len;
+    text[_length] = 0;
+	return true;
+}
+
+/**
+ * \brief Closes current file
+ *
+ * @return False on error
+ */
+bool uEspConfigLibFSMemory::closeFile() {
+    if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        _status = uEspConfigLibFS_STATUS_CLOSED;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * \brief Gets stored file content
+ *
+ * @return Char pointer to file content. Empty string if there is no valid content
+ */
+const char * uEspConfigLibFSMemory::data() {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE && !_validate()) {
+        return "";
+    }
+    return _data + uEspConfigLibFSMemory_MAGIC_SIZE;
+}
+
+/**
+ * \brief Gets stored file content length
+ *
+ * @return Length in bytes, 0 if there is no valid content
+ */
+size_t uEspConfigLibFSMemory::length() {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        _validate();
+    }
+    return _length;
+}
+
+/**
+ * \brief Discards stored content
+ */
+void uEspConfigLibFSMemory::clear() {
+    if (_data != 0 && _capacity > 0) {
+        _data[0] = 0; // Breaks mark
+    }
+    _length = 0;
+    _position = 0;
+    if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        _status = uEspConfigLibFS_STATUS_CLOSED;
+    }
+}
@@ -0,0 +1,151 @@
+/**
+ * \class uEspConfigLibFSMemory
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - RAM FileSystem interface implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ * 
+ * Currently storage classes are: SD-card, LittleFS, SPIFFS, EEPROM, RAM and none (values are lost after restart).
+ *
+ *
+ * @file uEspConfigLibFSMemory.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.1.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLibFSInterface.h"
+
+/**
+ * \brief Mark stored at the beginning of the memory image, used to detect valid content
+ */
+#define uEspConfigLibFSMemory_MAGIC "uECL"
+/**
+ * \brief Length of uEspConfigLibFSMemory_MAGIC
+ */
+#define uEspConfigLibFSMemory_MAGIC_SIZE 4
+
+
+class uEspConfigLibFSMemory : public uEspConfigLibFSInterface {
+    public:
+        /**
+         * \brief Constructor, heap buffer that grows as needed
+         *
+         * @param capacity Optional. Initial buffer size in bytes
+         */
+        uEspConfigLibFSMemory(const size_t = 0);
+
+        /**
+         * \brief Constructor, fixed caller-provided memory region (i.e.: RTC memory)
+         *
+         * Region content is kept as it is, so a previously saved configuration can be read again.
+         *
+         * @param region Memory region to be used
+         * @param size Region size in bytes
+         */
+        uEspConfigLibFSMemory(char *, const size_t);
+
+        /**
+         * \brief Destructor
+         */
+        ~uEspConfigLibFSMemory();
+
+        /**
+         * \brief Opens the file for read
+         *
+         * @return False on error or if there is no valid content
+         */
+        bool openToRead();
+
+        /**
+         * \brief Opens the file for write
+         *
+         * @return False on error
+         */
+        bool openToWrite();
+
+        /**
+         * \brief Reads a whole line from current file
+         *
+         * @param line String pointer where line will be read
+         * @return False on error
+         */
+        bool readLine(String *);
+
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
+        /**
+         * \brief Writes content to current file
+         *
+         * @param data char array pointer to be written
+         * @return False on error (i.e.: fixed region is full)
+         */
+        bool write(const char *);
+
+        /**
+         * \brief Closes current file
+         *
+         * @return False on error
+         */
+        bool closeFile();
+
+        /**
+         * \brief Gets stored file content
+         *
+         * @return Char pointer to file content. Empty string if there is no valid content
+         */
+        const char * data();
+
+        /**
+         * \brief Gets stored file content length
+         *
+         * @return Length in bytes, 0 if there is no valid content
+         */
+        size_t length();
+
+        /**
+         * \brief Discards stored content
+         */
+        void clear();
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "memory"
+         */
+        const char * typeName() { return "memory"; }
+
+    private:
+        bool _validate();
+        bool _reserve(const size_t);
+        char * _data = 0;
+        size_t _capacity = 0;
+        size_t _length = 0;
+        size_t _position = 0;
+        bool _external = false;
+};
@@ -0,0 +1,129 @@
+/**
+ * \class uEspConfigLibFSMount
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Shared filesystem mount part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Keeps track of mounted filesystems, so any number of storages and config instances using files on the same
+ * filesystem mount it (and format it, if needed) only once.
+ *
+ *
+ * @file uEspConfigLibFSMount.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibFSMount.h"
+#include "uEspConfigLibFSLittlefs.h"
+#include "uEspConfigLibFSSpiffs.h"
+#include "uEspConfigLibFSSd.h"
+
+bool uEspConfigLibFSMount::_mounted[uEspConfigLibFSMount_COUNT] = {false, false, false};
+bool uEspConfigLibFSMount::_formatted[uEspConfigLibFSMount_COUNT] = {false, false, false};
+unsigned long uEspConfigLibFSMount::_mountTime[uEspConfigLibFSMount_COUNT] = {0, 0, 0};
+
+/**
+ * \brief Mounts a filesystem, formatting it if needed, unless it is already mounted
+ *
+ * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+ * @param pin SD-card CS pin, only used by first SD-card mount
+ * @return False on error
+ */
+bool uEspConfigLibFSMount::mount(const uint8_t fs, const uint8_t pin) {
+    if (fs >= uEspConfigLibFSMount_COUNT) {
+        return false;
+    }
+    if (_mounted[fs]) {
+        return true;
+    }
+    unsigned long start = uEspConfigLib_micros();
+    bool correct = false;
+    switch (fs) {
+        case uEspConfigLibFSMount_LITTLEFS:
+            correct = LittleFS.begin(uEspConfigLibFSLittlefs_begin_param);
+            yield();
+            if (!correct) {
+                LittleFS.format();
+                _formatted[fs] = true;
+                yield();
+                correct = LittleFS.begin();
+                yield();
+            }
+            break;
+
+        case uEspConfigLibFSMount_SPIFFS:
+            correct = SPIFFS.begin();
+            yield();
+            if (!correct) {
+                SPIFFS.format();
+                _formatted[fs] = true;
+                yield();
+                correct = SPIFFS.begin();
+                yield();
+            }
+            break;
+
+        case uEspConfigLibFSMount_SD:
+            correct = SD.begin(pin);
+            break;
+    }
+    _mountTime[fs] = uEspConfigLib_micros() - start;
+    _mounted[fs] = correct; // Failed mounts are retried on next call
+    return correct;
+}
+
+/**
+ * \brief Checks if a filesystem is mounted
+ *
+ * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+ * @return True if mounted
+ */
+bool uEspConfigLibFSMount::isMounted(const uint8_t fs) {
+    return fs < uEspConfigLibFSMount_COUNT && _mounted[fs];
+}
+
+/**
+ * \brief Returns time spent mounting a filesystem, including format if needed
+ *
+ * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+ * @return Microseconds
+ */
+unsigned long uEspConfigLibFSMount::mountTime(const uint8_t fs) {
+    return fs < uEspConfigLibFSMount_COUNT ? _mountTime[fs] : 0;
+}
+
+/**
+ * \brief Returns if a filesystem had to be formatted to be mounted
+ *
+ * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+ * @return True if formatted
+ */
+bool uEspConfigLibFSMount::formatted(const uint8_t fs) {
+    return fs < uEspConfigLibFSMount_COUNT && _formatted[fs];
+}
+
+/**
+ * \brief Unmounts a filesystem
+ *
+ * Storages using it will fail until it is mounted again.
+ *
+ * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+ */
+void uEspConfigLibFSMount::unmount(const uint8_t fs) {
+    if (!isMounted(fs)) {
+        return;
+    }
+    switch (fs) {
+        case uEspConfigLibFSMount_LITTLEFS: LittleFS.end(); break;
+        case uEspConfigLibFSMount_SPIFFS: SPIFFS.end(); break;
+        case uEspConfigLibFSMount_SD: SD.end(); break;
+    }
+    _mounted[fs] = false;
+}
@@ -0,0 +1,91 @@
+/**
+ * \class uEspConfigLibFSMount
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Shared filesystem mount part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Keeps track of mounted filesystems, so any number of storages and config instances using files on the same
+ * filesystem mount it (and format it, if needed) only once.
+ *
+ *
+ * @file uEspConfigLibFSMount.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * \brief Filesystem: LittleFS
+ */
+#define uEspConfigLibFSMount_LITTLEFS 0
+/**
+ * \brief Filesystem: SPIFFS
+ */
+#define uEspConfigLibFSMount_SPIFFS 1
+/**
+ * \brief Filesystem: SD-card
+ */
+#define uEspConfigLibFSMount_SD 2
+/**
+ * \brief Number of known filesystems
+ */
+#define uEspConfigLibFSMount_COUNT 3
+
+class uEspConfigLibFSMount {
+    public:
+        /**
+         * \brief Mounts a filesystem, formatting it if needed, unless it is already mounted
+         *
+         * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+         * @param pin SD-card CS pin, only used by first SD-card mount
+         * @return False on error
+         */
+        static bool mount(const uint8_t, const uint8_t = 0);
+
+        /**
+         * \brief Checks if a filesystem is mounted
+         *
+         * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+         * @return True if mounted
+         */
+        static bool isMounted(const uint8_t);
+
+        /**
+         * \brief Returns time spent mounting a filesystem, including format if needed
+         *
+         * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+         * @return Microseconds
+         */
+        static unsigned long mountTime(const uint8_t);
+
+        /**
+         * \brief Returns if a filesystem had to be formatted to be mounted
+         *
+         * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+         * @return True if formatted
+         */
+        static bool formatted(const uint8_t);
+
+        /**
+         * \brief Unmounts a filesystem
+         *
+         * Storages using it will fail until it is mounted again.
+         *
+         * @param fs Filesystem, uEspConfigLibFSMount_LITTLEFS, uEspConfigLibFSMount_SPIFFS or uEspConfigLibFSMount_SD
+         */
+        static void unmount(const uint8_t);
+
+    private:
+        static bool _mounted[uEspConfigLibFSMount_COUNT];
+        static bool _formatted[uEspConfigLibFSMount_COUNT];
+        static unsigned long _mountTime[uEspConfigLibFSMount_COUNT];
+};
@@ -59,6 +59,26 @@ bool uEspConfigLibFSNone::openToWrite() {return true;}
  */
 bool uEspConfigLibFSNone::readLine(String *unused) {return false;}
 
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSNone::readLine(char *unused, const size_t size) {return false;}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSNone::read(char *unused, const size_t size) {return 0;}
+
 /**
  * \brief Writes content to current file
  *
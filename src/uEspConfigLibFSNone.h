@@ -61,6 +61,26 @@ class uEspConfigLibFSNone : public uEspConfigLibFSInterface {
          */
         bool readLine(String *);
 
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
         /**
          * \brief Writes content to current file
          *
@@ -76,8 +96,13 @@ class uEspConfigLibFSNone : public uEspConfigLibFSInterface {
          */
         bool closeFile();
 
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "none"
+         */
+        const char * typeName() { return "none"; }
+
     private:
-        uint8_t _status;
-        char * _path = 0;
 };
 
@@ -25,12 +25,6 @@
 #include <SPI.h>
 #include <SD.h>
 
-#ifdef ARDUINO_ARCH_ESP32
-    #define uEspConfigLibFSSd_writeCasted(data) _dataFile.write((uint8_t *) data, strlen(data))
-#else
-    #define uEspConfigLibFSSd_writeCasted(data) _dataFile.write(data, strlen(data))
-#endif
-
 
 class uEspConfigLibFSSd : public uEspConfigLibFSInterface {
     public:
@@ -50,6 +44,11 @@ class uEspConfigLibFSSd : public uEspConfigLibFSInterface {
          */
         uEspConfigLibFSSd(const char*, const bool = false, const uint8_t = SS);
 
+        /**
+         * \brief Destructor, closes current file writing pending buffer content
+         */
+        ~uEspConfigLibFSSd();
+
         /**
          * \brief Opens the file for read
          *
@@ -72,6 +71,26 @@ class uEspConfigLibFSSd : public uEspConfigLibFSInterface {
          */
         bool readLine(String *);
 
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
         /**
          * \brief Writes content to current file
          *
@@ -87,9 +106,17 @@ class uEspConfigLibFSSd : public uEspConfigLibFSInterface {
          */
         bool closeFile();
 
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "sd"
+         */
+        const char * typeName() { return "sd"; }
+
+    protected:
+        size_t _rawWrite(const uint8_t *, const size_t);
+
     private:
-        uint8_t _status;
-        char * _path = 0;
     	File _dataFile;
 };
 
@@ -20,6 +20,7 @@
  */#include <Arduino.h>
 #include "uEspConfigLibFSInterface.h"
 #include "uEspConfigLibFSSpiffs.h"
+#include "uEspConfigLibFSMount.h"
 
 
 /**
@@ -27,9 +28,7 @@
  *
  * @param init Set to true if you want to initialize and format (if needed) the filesystem
  */
-uEspConfigLibFSSpiffs::uEspConfigLibFSSpiffs(const bool init) {
-    uEspConfigLibFSSpiffs("/uEspConfig.ini", init);
-}
+uEspConfigLibFSSpiffs::uEspConfigLibFSSpiffs(const bool init) : uEspConfigLibFSSpiffs("/uEspConfig.ini", init) {}
 	
 /**
  * \brief Constructor
@@ -44,25 +43,27 @@ uEspConfigLibFSSpiffs::uEspConfigLibFSSpiffs(const char *path, const bool init)
     _path = (char *) malloc(sizeof(char) * (strlen(path) + 1));
     strcpy(_path, path);
     
-    // Init FS if requested
+    // Init FS if requested; shared, so it is mounted only once
 	if (init) {
-        _status = uEspConfigLibFS_STATUS_NOINIT;
-	    bool correct = SPIFFS.begin();
-		yield();
-	    if (!correct) {
-		    SPIFFS.format();
-    		yield();
-		    correct = SPIFFS.begin();
-    		yield();
-	    }
-	    if (correct) {
+        bool mounted = uEspConfigLibFSMount::isMounted(uEspConfigLibFSMount_SPIFFS);
+        unsigned long start = uEspConfigLib_micros();
+	    if (uEspConfigLibFSMount::mount(uEspConfigLibFSMount_SPIFFS)) {
 	        _status = uEspConfigLibFS_STATUS_CLOSED;
 	    } else {
 	        _status = uEspConfigLibFS_STATUS_FATAL;
         }
+        _mountTime = uEspConfigLib_micros() - start;
+        _formatted = !mounted && uEspConfigLibFSMount::formatted(uEspConfigLibFSMount_SPIFFS);
 	}
 }
 
+/**
+ * \brief Destructor, closes current file writing pending buffer content
+ */
+uEspConfigLibFSSpiffs::~uEspConfigLibFSSpiffs() {
+    closeFile();
+}
+
 /**
  * \brief Opens the file for read
  *
@@ -74,6 +75,9 @@ bool uEspConfigLibFSSpiffs::openToRead() {
     }
 
     if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+            _bufferedFlush();
+        }
 	    _dataFile.close();
         _status = uEspConfigLibFS_STATUS_CLOSED;
 		yield();
@@ -100,6 +104,9 @@ bool uEspConfigLibFSSpiffs::openToWrite() {
     }
 
     if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+            _bufferedFlush();
+        }
 	    _dataFile.close();
         _status = uEspConfigLibFS_STATUS_CLOSED;
 		yield();
@@ -110,6 +117,7 @@ bool uEspConfigLibFSSpiffs::openToWrite() {
         _status = uEspConfigLibFS_STATUS_ERROR;
         return false;
     }
+    _writeBufferPosition = 0;
     _status = uEspConfigLibFS_STATUS_OPEN_WRITE;
 	return true;
 }
@@ -126,14 +134,56 @@ bool uEspConfigLibFSSpiffs::readLine(String *line) {
 	    return false;
     }
 	if (_dataFile.available()) {    
-		yield();
 	    *line = _dataFile.readStringUntil('\n');
-		yield();
+        uEspConfigLibYield::step(line->length());
         return true;
     }
     return false;
 }
 
+/**
+ * \brief Reads a whole line from current file into a char buffer, without heap allocations
+ *
+ * Lines longer than buffer are truncated and the rest of the line is discarded.
+ *
+ * @param line Buffer where line will be read, without line ending
+ * @param size Buffer size, including string terminator
+ * @return False on error or end of file
+ */
+bool uEspConfigLibFSSpiffs::readLine(char *line, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ || size == 0) {
+	    return false;
+    }
+	if (!_dataFile.available()) {
+        return false;
+    }
+    size_t len = 0;
+    int actualChar;
+    while ((actualChar = _dataFile.read()) >= 0 && actualChar != '\n') {
+        if (len + 1 < size) {
+            line[len] = (char) actualChar;
+            len++;
+        }
+    }
+    line[len] = 0;
+    uEspConfigLibYield::step(len);
+    return true;
+}
+
+/**
+ * \brief Reads raw content from current file
+ *
+ * @param data Buffer where content will be read
+ * @param size Buffer size
+ * @return Number of bytes read, 0 on error or end of file
+ */
+size_t uEspConfigLibFSSpiffs::read(char *data, const size_t size) {
+    if (_status != uEspConfigLibFS_STATUS_OPEN_READ) {
+	    return 0;
+    }
+    return _dataFile.read((uint8_t *) data, size);
+}
+
 /**
  * \brief Writes content to current file
  *
@@ -144,7 +194,18 @@ bool uEspConfigLibFSSpiffs::write(const char *data) {
     if (_status != uEspConfigLibFS_STATUS_OPEN_WRITE) {
 	    return false;
     }
-	return (uEspConfigLibFSSpiffs_writeCasted(data) > 0);
+	return _bufferedWrite(data);
+}
+
+/**
+ * \brief Writes raw content to current file, used by write buffer
+ *
+ * @param data Bytes to be written
+ * @param len Number of bytes
+ * @return Number of bytes written
+ */
+size_t uEspConfigLibFSSpiffs::_rawWrite(const uint8_t *data, const size_t len) {
+    return _dataFile.write(data, len);
 }
 
 /**
@@ -154,10 +215,14 @@ bool uEspConfigLibFSSpiffs::write(const char *data) {
  */
 bool uEspConfigLibFSSpiffs::closeFile() {
     if (_status == uEspConfigLibFS_STATUS_OPEN_READ || _status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+        bool ret = true;
+        if (_status == uEspConfigLibFS_STATUS_OPEN_WRITE) {
+            ret = _bufferedFlush();
+        }
 	    _dataFile.close();
         _status = uEspConfigLibFS_STATUS_CLOSED;
 		yield();
-        return true;
+        return ret;
     }
     return false;
 }
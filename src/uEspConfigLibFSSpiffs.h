@@ -27,9 +27,6 @@
 
 #ifdef ARDUINO_ARCH_ESP32
     #include "SPIFFS.h"
-    #define uEspConfigLibFSSpiffs_writeCasted(data) _dataFile.write((uint8_t *) data, strlen(data))
-#else
-    #define uEspConfigLibFSSpiffs_writeCasted(data) _dataFile.write(data, strlen(data))
 #endif
 
 class uEspConfigLibFSSpiffs : public uEspConfigLibFSInterface {
@@ -49,6 +46,11 @@ class uEspConfigLibFSSpiffs : public uEspConfigLibFSInterface {
          */
         uEspConfigLibFSSpiffs(const char*, const bool=false);
 
+        /**
+         * \brief Destructor, closes current file writing pending buffer content
+         */
+        ~uEspConfigLibFSSpiffs();
+
         /**
          * \brief Opens the file for read
          *
@@ -71,6 +73,26 @@ class uEspConfigLibFSSpiffs : public uEspConfigLibFSInterface {
          */
         bool readLine(String *);
 
+        /**
+         * \brief Reads a whole line from current file into a char buffer, without heap allocations
+         *
+         * Lines longer than buffer are truncated and the rest of the line is discarded.
+         *
+         * @param line Buffer where line will be read, without line ending
+         * @param size Buffer size, including string terminator
+         * @return False on error or end of file
+         */
+        bool readLine(char *, const size_t);
+
+        /**
+         * \brief Reads raw content from current file
+         *
+         * @param data Buffer where content will be read
+         * @param size Buffer size
+         * @return Number of bytes read, 0 on error or end of file
+         */
+        size_t read(char *, const size_t);
+
         /**
          * \brief Writes content to current file
          *
@@ -86,9 +108,17 @@ class uEspConfigLibFSSpiffs : public uEspConfigLibFSInterface {
          */
         bool closeFile();
 
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "spiffs"
+         */
+        const char * typeName() { return "spiffs"; }
+
+    protected:
+        size_t _rawWrite(const uint8_t *, const size_t);
+
     private:
-        uint8_t _status;
-        char * _path = 0;
     	fs::File _dataFile;
 };
 
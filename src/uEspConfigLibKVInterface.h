@@ -0,0 +1,108 @@
+/**
+ * \class uEspConfigLibKVInterface
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Key/value storage interface part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Key/value storages keep each option as an independent record, so changing one option writes only that record.
+ *
+ * Currently key/value storage classes are: RAM and ESP32 Preferences (NVS).
+ *
+ *
+ * @file uEspConfigLibKVInterface.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLibFSInterface.h"
+
+class uEspConfigLibKVInterface {
+    public:
+        /**
+         * \brief Destructor
+         */
+        virtual ~uEspConfigLibKVInterface() {};
+
+        /**
+         * \brief Reads the value stored for a key
+         *
+         * @param key Key (option name)
+         * @param value Buffer where value will be read
+         * @param size Buffer size, including string terminator
+         * @return False on error, if key is not stored or if value does not fit in buffer (see length())
+         */
+        virtual bool get(const char *, char *, const size_t) { return false; };
+
+        /**
+         * \brief Returns length of the value stored for a key
+         *
+         * @param key Key (option name)
+         * @return Value length, without string terminator. 0 if key is not stored, value is empty or storage cannot tell it
+         */
+        virtual size_t length(const char *) { return 0; };
+
+        /**
+         * \brief Stores a value for a key, replacing previous one
+         *
+         * @param key Key (option name)
+         * @param value Value to be stored
+         * @return False on error
+         */
+        virtual bool put(const char *, const char *) { return false; };
+
+        /**
+         * \brief Removes a key
+         *
+         * @param key Key (option name)
+         * @return False on error or if key is not stored
+         */
+        virtual bool erase(const char *) { return false; };
+
+        /**
+         * \brief Iterates stored records
+         *
+         * Start with cursor set to 0 and call it until it returns false.
+         *
+         * @param cursor Iteration position, updated on each call
+         * @param key Buffer where key will be read
+         * @param keySize Key buffer size, including string terminator
+         * @param value Buffer where value will be read
+         * @param valueSize Value buffer size, including string terminator
+         * @return False when there are no more records or if storage cannot be iterated
+         */
+        virtual bool next(size_t *, char *, const size_t, char *, const size_t) { return false; };
+
+        /**
+         * \brief Returns current status
+         *
+         * @return Current status, uEspConfigLibFS_STATUS_*
+         */
+        uint8_t status() { return _status; }
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return Type name, i.e.: "preferences"
+         */
+        virtual const char * typeName() { return "custom"; }
+
+        /**
+         * \brief Returns bytes (keys and values) written since object creation
+         *
+         * @return Bytes
+         */
+        size_t bytesWritten() { return _bytesWritten; }
+
+    protected:
+        uint8_t _status = uEspConfigLibFS_STATUS_CLOSED;
+        size_t _bytesWritten = 0;
+};
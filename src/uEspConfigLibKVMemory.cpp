@@ -0,0 +1,154 @@
+/**
+ * \class uEspConfigLibKVMemory
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - RAM key/value storage implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This is the reference key/value storage implementation; values are lost after restart.
+ *
+ *
+ * @file uEspConfigLibKVMemory.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibKVInterface.h"
+#include "uEspConfigLibKVMemory.h"
+
+#define uEspConfigLibKVMemory_copy(field, data) if (field != 0) { free(field); } field = (char *) malloc(sizeof(char) * (strlen(data) + 1)); strcpy(field, data);
+
+
+/**
+ * \brief Constructor
+ */
+uEspConfigLibKVMemory::uEspConfigLibKVMemory() {
+    _status = uEspConfigLibFS_STATUS_CLOSED;
+}
+
+uEspConfigLibKVMemoryRecord * uEspConfigLibKVMemory::_find(const char * key) {
+    for (uEspConfigLibKVMemoryRecord * record = _records; record != 0; record = record->next) {
+        if (strcmp(record->key, key) == 0) {
+            return record;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Reads the value stored for a key
+ *
+ * @param key Key (option name)
+ * @param value Buffer where value will be read
+ * @param size Buffer size, including string terminator
+ * @return False on error, if key is not stored or if value does not fit in buffer (see length())
+ */
+bool uEspConfigLibKVMemory::get(const char * key, char * value, const size_t size) {
+    uEspConfigLibKVMemoryRecord * record = _find(key);
+    if (record == 0 || strlen(record->value) >= size) {
+        return false;
+    }
+    strcpy(value, record->value);
+    return true;
+}
+
+/**
+ * \brief Returns length of the value stored for a key
+ *
+ * @param key Key (option name)
+ * @return Value length, without string terminator. 0 if key is not stored or value is empty
+ */
+size_t uEspConfigLibKVMemory::length(const char * key) {
+    uEspConfigLibKVMemoryRecord * record = _find(key);
+    return record != 0 ? strlen(record->value) : 0;
+}
+
+/**
+ * \brief Stores a value for a key, replacing previous one
+ *
+ * @param key Key (option name)
+ * @param value Value to be stored
+ * @return False on error
+ */
+bool uEspConfigLibKVMemory::put(const char * key, const char * value) {
+    uEspConfigLibKVMemoryRecord * record = _find(key);
+    if (record == 0) {
+        record = new uEspConfigLibKVMemoryRecord;
+        uEspConfigLibKVMemory_copy(record->key, key);
+        record->next = _records;
+        _records = record;
+    }
+    uEspConfigLibKVMemory_copy(record->value, value);
+    _writes++;
+    _bytesWritten += strlen(key) + strlen(value);
+    return true;
+}
+
+/**
+ * \brief Removes a key
+ *
+ * @param key Key (option name)
+ * @return False on error or if key is not stored
+ */
+bool uEspConfigLibKVMemory::erase(const char * key) {
+    uEspConfigLibKVMemoryRecord * prev = 0;
+    for (uEspConfigLibKVMemoryRecord * record = _records; record != 0; record = record->next) {
+        if (strcmp(record->key, key) == 0) {
+            if (prev == 0) {
+                _records = record->next;
+            } else {
+                prev->next = record->next;
+            }
+            free(record->key);
+            free(record->value);
+            delete record;
+            _writes++;
+            return true;
+        }
+        prev = record;
+    }
+    return false;
+}
+
+/**
+ * \brief Iterates stored records
+ *
+ * Start with cursor set to 0 and call it until it returns false.
+ *
+ * @param cursor Iteration position, updated on each call
+ * @param key Buffer where key will be read
+ * @param keySize Key buffer size, including string terminator
+ * @param value Buffer where value will be read
+ * @param valueSize Value buffer size, including string terminator
+ * @return False when there are no more records
+ */
+bool uEspConfigLibKVMemory::next(size_t * cursor, char * key, const size_t keySize, char * value, const size_t valueSize) {
+    uEspConfigLibKVMemoryRecord * record = _records;
+    for (size_t i = 0; i < *cursor && record != 0; i++) {
+        record = record->next;
+    }
+    if (record == 0 || keySize == 0 || valueSize == 0) {
+        return false;
+    }
+    strncpy(key, record->key, keySize - 1);
+    key[keySize - 1] = 0;
+    strncpy(value, record->value, valueSize - 1);
+    value[valueSize - 1] = 0;
+    (*cursor)++;
+    return true;
+}
+
+/**
+ * \brief Gets number of record writes done (put and erase), useful to measure storage usage
+ *
+ * @return Number of writes
+ */
+unsigned long uEspConfigLibKVMemory::writes() {
+    return _writes;
+}
@@ -0,0 +1,107 @@
+/**
+ * \class uEspConfigLibKVMemory
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - RAM key/value storage implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This is the reference key/value storage implementation; values are lost after restart.
+ *
+ *
+ * @file uEspConfigLibKVMemory.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLibKVInterface.h"
+
+struct uEspConfigLibKVMemoryRecord {
+    uEspConfigLibKVMemoryRecord() : next(0), key(0), value(0) {};
+    uEspConfigLibKVMemoryRecord *next;
+    char * key;
+    char * value;
+};
+
+class uEspConfigLibKVMemory : public uEspConfigLibKVInterface {
+    public:
+        /**
+         * \brief Constructor
+         */
+        uEspConfigLibKVMemory();
+
+        /**
+         * \brief Reads the value stored for a key
+         *
+         * @param key Key (option name)
+         * @param value Buffer where value will be read
+         * @param size Buffer size, including string terminator
+         * @return False on error, if key is not stored or if value does not fit in buffer (see length())
+         */
+        bool get(const char *, char *, const size_t);
+
+        /**
+         * \brief Returns length of the value stored for a key
+         *
+         * @param key Key (option name)
+         * @return Value length, without string terminator. 0 if key is not stored or value is empty
+         */
+        size_t length(const char *);
+
+        /**
+         * \brief Stores a value for a key, replacing previous one
+         *
+         * @param key Key (option name)
+         * @param value Value to be stored
+         * @return False on error
+         */
+        bool put(const char *, const char *);
+
+        /**
+         * \brief Removes a key
+         *
+         * @param key Key (option name)
+         * @return False on error or if key is not stored
+         */
+        bool erase(const char *);
+
+        /**
+         * \brief Iterates stored records
+         *
+         * Start with cursor set to 0 and call it until it returns false.
+         *
+         * @param cursor Iteration position, updated on each call
+         * @param key Buffer where key will be read
+         * @param keySize Key buffer size, including string terminator
+         * @param value Buffer where value will be read
+         * @param valueSize Value buffer size, including string terminator
+         * @return False when there are no more records
+         */
+        bool next(size_t *, char *, const size_t, char *, const size_t);
+
+        /**
+         * \brief Gets number of record writes done (put and erase), useful to measure storage usage
+         *
+         * @return Number of writes
+         */
+        unsigned long writes();
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "memory"
+         */
+        const char * typeName() { return "memory"; }
+
+    private:
+        uEspConfigLibKVMemoryRecord * _find(const char *);
+        uEspConfigLibKVMemoryRecord * _records = 0;
+        unsigned long _writes = 0;
+};
@@ -0,0 +1,131 @@
+/**
+ * \class uEspConfigLibKVPreferences
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - ESP32 Preferences (NVS) key/value storage implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This storage is only available on ESP32.
+ *
+ *
+ * @file uEspConfigLibKVPreferences.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#ifdef ARDUINO_ARCH_ESP32
+
+#include <Arduino.h>
+#include "uEspConfigLibKVInterface.h"
+#include "uEspConfigLibKVPreferences.h"
+
+
+/**
+ * \brief Constructor
+ *
+ * @param ns Optional. NVS namespace to be used, up to 15 characters
+ */
+uEspConfigLibKVPreferences::uEspConfigLibKVPreferences(const char * ns) {
+    if (_preferences.begin(ns, false)) {
+        _status = uEspConfigLibFS_STATUS_CLOSED;
+    } else {
+        _status = uEspConfigLibFS_STATUS_FATAL;
+    }
+}
+
+/**
+ * \brief Maps an option name to a valid NVS key
+ *
+ * Names longer than NVS limit are replaced by '~' and their FNV-1a hash in hex.
+ *
+ * @param name Option name
+ * @return NVS key
+ */
+const char * uEspConfigLibKVPreferences::_key(const char * name) {
+    if (strlen(name) <= uEspConfigLibKVPreferences_KEY_SIZE) {
+        return name;
+    }
+    uint32_t hash = 2166136261UL;
+    for (const char * c = name; *c != 0; c++) {
+        hash ^= (uint8_t) *c;
+        hash *= 16777619UL;
+    }
+    snprintf(_keyBuffer, sizeof(_keyBuffer), "~%08lx", (unsigned long) hash);
+    return _keyBuffer;
+}
+
+/**
+ * \brief Reads the value stored for a key
+ *
+ * @param key Key (option name)
+ * @param value Buffer where value will be read
+ * @param size Buffer size, including string terminator
+ * @return False on error, if key is not stored or if value does not fit in buffer (see length())
+ */
+bool uEspConfigLibKVPreferences::get(const char * key, char * value, const size_t size) {
+    if (_status == uEspConfigLibFS_STATUS_FATAL || size == 0) {
+        return false;
+    }
+    const char * nvsKey = _key(key);
+    if (!_preferences.isKey(nvsKey)) {
+        return false;
+    }
+    // Preferences returns read length including terminator, 0 on error or if value does not fit
+    return _preferences.getString(nvsKey, value, size) > 0;
+}
+
+/**
+ * \brief Returns length of the value stored for a key
+ *
+ * @param key Key (option name)
+ * @return Value length, without string terminator. 0 if key is not stored or value is empty
+ */
+size_t uEspConfigLibKVPreferences::length(const char * key) {
+    if (_status == uEspConfigLibFS_STATUS_FATAL) {
+        return 0;
+    }
+    const char * nvsKey = _key(key);
+    if (!_preferences.isKey(nvsKey)) {
+        return 0;
+    }
+    return _preferences.getString(nvsKey).length();
+}
+
+/**
+ * \brief Stores a value for a key, replacing previous one
+ *
+ * @param key Key (option name)
+ * @param value Value to be stored
+ * @return False on error
+ */
+bool uEspConfigLibKVPreferences::put(const char * key, const char * value) {
+    if (_status == uEspConfigLibFS_STATUS_FATAL) {
+        return false;
+    }
+    // Preferences returns stored length, so 0 is also correct for empty values
+    if (_preferences.putString(_key(key), value) == 0 && *value != 0) {
+        return false;
+    }
+    _bytesWritten += strlen(key) + strlen(value);
+    return true;
+}
+
+/**
+ * \brief Removes a key
+ *
+ * @param key Key (option name)
+ * @return False on error or if key is not stored
+ */
+bool uEspConfigLibKVPreferences::erase(const char * key) {
+    if (_status == uEspConfigLibFS_STATUS_FATAL) {
+        return false;
+    }
+    return _preferences.remove(_key(key));
+}
+
+#endif
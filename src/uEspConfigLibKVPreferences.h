@@ -0,0 +1,92 @@
+/**
+ * \class uEspConfigLibKVPreferences
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - ESP32 Preferences (NVS) key/value storage implementation part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This storage is only available on ESP32.
+ *
+ *
+ * @file uEspConfigLibKVPreferences.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#ifdef ARDUINO_ARCH_ESP32
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "uEspConfigLibKVInterface.h"
+
+/**
+ * \brief Maximum NVS key length; longer option names are stored using a hash
+ */
+#define uEspConfigLibKVPreferences_KEY_SIZE 15
+
+
+class uEspConfigLibKVPreferences : public uEspConfigLibKVInterface {
+    public:
+        /**
+         * \brief Constructor
+         *
+         * @param ns Optional. NVS namespace to be used, up to 15 characters
+         */
+        uEspConfigLibKVPreferences(const char * = "uEspConfig");
+
+        /**
+         * \brief Reads the value stored for a key
+         *
+         * @param key Key (option name)
+         * @param value Buffer where value will be read
+         * @param size Buffer size, including string terminator
+         * @return False on error, if key is not stored or if value does not fit in buffer (see length())
+         */
+        bool get(const char *, char *, const size_t);
+
+        /**
+         * \brief Returns length of the value stored for a key
+         *
+         * @param key Key (option name)
+         * @return Value length, without string terminator. 0 if key is not stored or value is empty
+         */
+        size_t length(const char *);
+
+        /**
+         * \brief Stores a value for a key, replacing previous one
+         *
+         * @param key Key (option name)
+         * @param value Value to be stored
+         * @return False on error
+         */
+        bool put(const char *, const char *);
+
+        /**
+         * \brief Removes a key
+         *
+         * @param key Key (option name)
+         * @return False on error or if key is not stored
+         */
+        bool erase(const char *);
+
+        /**
+         * \brief Returns storage type name, used on metrics
+         *
+         * @return "preferences"
+         */
+        const char * typeName() { return "preferences"; }
+
+    private:
+        const char * _key(const char *);
+        char _keyBuffer[uEspConfigLibKVPreferences_KEY_SIZE + 1];
+        Preferences _preferences;
+};
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * \class uEspConfigLibMetrics
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Metrics part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Operational counters, always updated by uEspConfigLib and served in Prometheus text format by handleMetrics.
+ * Durations are in microseconds.
+ *
+ *
+ * @file uEspConfigLibMetrics.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+
+struct uEspConfigLibMetrics {
+    uEspConfigLibMetrics() : loads(0), loadErrors(0), loadMicros(0), saves(0), saveErrors(0), saveMicros(0), requests(0), responseBytes(0), responseMicros(0), scans(0), heap(0) {};
+    unsigned long loads;
+    unsigned long loadErrors;
+    uint64_t loadMicros;
+    unsigned long saves;
+    unsigned long saveErrors;
+    uint64_t saveMicros;
+    unsigned long requests;
+    uint64_t responseBytes;
+    uint64_t responseMicros;
+    unsigned long scans;
+    size_t heap;
+};
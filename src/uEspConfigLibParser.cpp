@@ -0,0 +1,222 @@
+/**
+ * \class uEspConfigLibParser
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Configuration file parser part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ * 
+ * Currently storage classes are: SD-card, LittleFS, SPIFFS, EEPROM, RAM and none (values are lost after restart).
+ *
+ *
+ * @file uEspConfigLibParser.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibParser.h"
+
+#define uEspConfigLibParser_isBlank(c) (c == ' ' || c == '\t' || c == '\v' || c == '\f')
+#define uEspConfigLibParser_isEol(c) (c == '\n' || c == '\r')
+
+
+/**
+ * \brief Constructor
+ *
+ * @param grow Optional. False to never use heap: names and values longer than fixed buffers are discarded. Default true
+ */
+uEspConfigLibParser::uEspConfigLibParser(const bool grow) {
+    _grow = grow;
+    _name = _nameFixed;
+    _value = _valueFixed;
+    _nameSize = uEspConfigLibParser_NAME_SIZE;
+    _valueSize = uEspConfigLibParser_VALUE_SIZE;
+    reset();
+}
+
+/**
+ * \brief Destructor, frees heap used by long names or values
+ */
+uEspConfigLibParser::~uEspConfigLibParser() {
+    if (_name != _nameFixed) {
+        free(_name);
+    }
+    if (_value != _valueFixed) {
+        free(_value);
+    }
+}
+
+/**
+ * \brief Resets parser state, to start a new file
+ */
+void uEspConfigLibParser::reset() {
+    _state = uEspConfigLibParser_STATE_LINE_START;
+    _nameLength = 0;
+    _nameTrimmed = 0;
+    _valueLength = 0;
+    _valueTrimmed = 0;
+    _name[0] = 0;
+    _value[0] = 0;
+    _discarded = false;
+}
+
+/**
+ * \brief Processes one character of the configuration file
+ *
+ * Syntax is "name = value" lines; spaces around name and value are ignored, as well as empty lines and comment lines starting with #, ; or //.
+ * Both LF and CRLF line endings are accepted.
+ *
+ * @param c Character to be processed
+ * @return True when a whole name/value pair has been read, available with name() and value() until next call
+ */
+bool uEspConfigLibParser::feed(const char c) {
+    if (uEspConfigLibParser_isEol(c)) {
+        return _endLine();
+    }
+    switch (_state) {
+        case uEspConfigLibParser_STATE_LINE_START:
+            if (uEspConfigLibParser_isBlank(c)) {
+                return false;
+            }
+            _nameLength = 0;
+            _nameTrimmed = 0;
+            _valueLength = 0;
+            _valueTrimmed = 0;
+            if (c == '#' || c == ';') {
+                _state = uEspConfigLibParser_STATE_COMMENT;
+            } else if (c == '/') {
+                _state = uEspConfigLibParser_STATE_SLASH;
+            } else if (c == '=') { // Empty name
+                _state = uEspConfigLibParser_STATE_SKIP;
+            } else {
+                _name[0] = c;
+                _nameLength = 1;
+                _nameTrimmed = 1;
+                _state = uEspConfigLibParser_STATE_NAME;
+            }
+            return false;
+
+        case uEspConfigLibParser_STATE_SLASH:
+            if (c == '/') {
+                _state = uEspConfigLibParser_STATE_COMMENT;
+                return false;
+            }
+            // Just a name starting with '/'
+            _name[0] = '/';
+            _nameLength = 1;
+            _nameTrimmed = 1;
+            _state = uEspConfigLibParser_STATE_NAME;
+            return feed(c);
+
+        case uEspConfigLibParser_STATE_NAME:
+            if (c == '=') {
+                _name[_nameTrimmed] = 0;
+                _state = uEspConfigLibParser_STATE_VALUE_START;
+            } else if (!_append(&_name, &_nameSize, _nameFixed, &_nameLength, c)) { // Too long or out of memory, line cannot be read
+                _state = uEspConfigLibParser_STATE_SKIP;
+                _discarded = true;
+            } else if (!uEspConfigLibParser_isBlank(c)) {
+                _nameTrimmed = _nameLength;
+            }
+            return false;
+
+        case uEspConfigLibParser_STATE_VALUE_START:
+            if (uEspConfigLibParser_isBlank(c)) {
+                return false;
+            }
+            _state = uEspConfigLibParser_STATE_VALUE;
+            // fall through
+        case uEspConfigLibParser_STATE_VALUE:
+            if (!_append(&_value, &_valueSize, _valueFixed, &_valueLength, c)) { // Too long or out of memory, line is skipped instead of truncated
+                _state = uEspConfigLibParser_STATE_SKIP;
+                _discarded = true;
+            } else if (!uEspConfigLibParser_isBlank(c)) {
+                _valueTrimmed = _valueLength;
+            }
+            return false;
+
+        default: // Comment or skipped line
+            return false;
+    }
+}
+
+/**
+ * \brief Ends current file
+ *
+ * @return True if last line, without line ending, contained a name/value pair
+ */
+bool uEspConfigLibParser::finish() {
+    return _endLine();
+}
+
+/**
+ * \brief Gets last parsed option name
+ *
+ * @return Char pointer to name
+ */
+const char * uEspConfigLibParser::name() {
+    return _name;
+}
+
+/**
+ * \brief Gets last parsed option value
+ *
+ * @return Char pointer to value
+ */
+const char * uEspConfigLibParser::value() {
+    return _value;
+}
+
+/**
+ * \brief Checks if any line was discarded since last reset(), being too long or not fitting in memory
+ *
+ * @return True if a line was discarded
+ */
+bool uEspConfigLibParser::discarded() {
+    return _discarded;
+}
+
+bool uEspConfigLibParser::_endLine() {
+    bool found = (_state == uEspConfigLibParser_STATE_VALUE_START || _state == uEspConfigLibParser_STATE_VALUE);
+    if (found) {
+        _value[_valueTrimmed] = 0;
+    }
+    _state = uEspConfigLibParser_STATE_LINE_START;
+    return found;
+}
+
+// Appends a character, moving buffer to heap (or growing it) when full and allowed, up to uEspConfigLibParser_MAX_SIZE.
+// Keeps room for string terminator
+bool uEspConfigLibParser::_append(char ** buffer, size_t * size, char * fixed, size_t * length, const char c) {
+    if (*length + 1 >= *size) {
+        char * grown;
+        size_t grownSize = *size * 2;
+        if (grownSize > uEspConfigLibParser_MAX_SIZE) {
+            grownSize = uEspConfigLibParser_MAX_SIZE;
+        }
+        if (!_grow || grownSize <= *size) {
+            return false;
+        }
+        if (*buffer == fixed) {
+            grown = (char *) malloc(grownSize);
+            if (grown != 0) {
+                memcpy(grown, fixed, *length);
+            }
+        } else {
+            grown = (char *) realloc(*buffer, grownSize);
+        }
+        if (grown == 0) {
+            return false;
+        }
+        *buffer = grown;
+        *size = grownSize;
+    }
+    (*buffer)[*length] = c;
+    (*length)++;
+    return true;
+}
@@ -0,0 +1,150 @@
+/**
+ * \class uEspConfigLibParser
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Configuration file parser part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ * 
+ * Currently storage classes are: SD-card, LittleFS, SPIFFS, EEPROM, RAM and none (values are lost after restart).
+ *
+ *
+ * @file uEspConfigLibParser.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * \brief Option name length parsed without heap use, including string terminator. Longer names are moved to heap, if allowed
+ */
+#ifndef uEspConfigLibParser_NAME_SIZE
+    #define uEspConfigLibParser_NAME_SIZE 64
+#endif
+/**
+ * \brief Option value length parsed without heap use, including string terminator. Longer values are moved to heap, if allowed
+ */
+#ifndef uEspConfigLibParser_VALUE_SIZE
+    #define uEspConfigLibParser_VALUE_SIZE 256
+#endif
+/**
+ * \brief Maximum option name or value length moved to heap, including string terminator. Longer lines are discarded
+ */
+#ifndef uEspConfigLibParser_MAX_SIZE
+    #define uEspConfigLibParser_MAX_SIZE 4096
+#endif
+
+/**
+ * \brief Parser state: at line start, skipping spaces
+ */
+#define uEspConfigLibParser_STATE_LINE_START 0
+/**
+ * \brief Parser state: a '/' was found at line start
+ */
+#define uEspConfigLibParser_STATE_SLASH 1
+/**
+ * \brief Parser state: inside a comment, until end of line
+ */
+#define uEspConfigLibParser_STATE_COMMENT 2
+/**
+ * \brief Parser state: reading option name
+ */
+#define uEspConfigLibParser_STATE_NAME 3
+/**
+ * \brief Parser state: '=' found, skipping spaces before value
+ */
+#define uEspConfigLibParser_STATE_VALUE_START 4
+/**
+ * \brief Parser state: reading option value
+ */
+#define uEspConfigLibParser_STATE_VALUE 5
+/**
+ * \brief Parser state: invalid line, skipping until end of line
+ */
+#define uEspConfigLibParser_STATE_SKIP 6
+
+
+class uEspConfigLibParser {
+    public:
+        /**
+         * \brief Constructor
+         *
+         * @param grow Optional. False to never use heap: names and values longer than fixed buffers are discarded. Default true
+         */
+        uEspConfigLibParser(const bool = true);
+
+        /**
+         * \brief Destructor, frees heap used by long names or values
+         */
+        ~uEspConfigLibParser();
+
+        /**
+         * \brief Resets parser state, to start a new file
+         */
+        void reset();
+
+        /**
+         * \brief Processes one character of the configuration file
+         *
+         * Syntax is "name = value" lines; spaces around name and value are ignored, as well as empty lines and comment lines starting with #, ; or //.
+         * Both LF and CRLF line endings are accepted.
+         *
+         * @param c Character to be processed
+         * @return True when a whole name/value pair has been read, available with name() and value() until next call
+         */
+        bool feed(const char);
+
+        /**
+         * \brief Ends current file
+         *
+         * @return True if last line, without line ending, contained a name/value pair
+         */
+        bool finish();
+
+        /**
+         * \brief Gets last parsed option name
+         *
+         * @return Char pointer to name
+         */
+        const char * name();
+
+        /**
+         * \brief Gets last parsed option value
+         *
+         * @return Char pointer to value
+         */
+        const char * value();
+
+        /**
+         * \brief Checks if any line was discarded since last reset(), being too long or not fitting in memory
+         *
+         * @return True if a line was discarded
+         */
+        bool discarded();
+
+    private:
+        uEspConfigLibParser(const uEspConfigLibParser &); // Not copyable, buffers may point to itself
+        uEspConfigLibParser & operator=(const uEspConfigLibParser &);
+        bool _endLine();
+        bool _append(char **, size_t *, char *, size_t *, const char);
+        char _nameFixed[uEspConfigLibParser_NAME_SIZE];
+        char _valueFixed[uEspConfigLibParser_VALUE_SIZE];
+        char * _name;
+        char * _value;
+        size_t _nameSize;
+        size_t _valueSize;
+        size_t _nameLength;
+        size_t _nameTrimmed;
+        size_t _valueLength;
+        size_t _valueTrimmed;
+        uint8_t _state;
+        bool _discarded;
+        bool _grow;
+};
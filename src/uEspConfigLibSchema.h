@@ -0,0 +1,92 @@
+/**
+ * \class uEspConfigLibSchema
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Option schema part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Option schemas are constant option tables with a minimal perfect hash for name lookup, generated at build time
+ * from a schema file by extras/schema_generator/uEspConfigLib_schema.py and used with uEspConfigLib::addSchema.
+ *
+ *
+ * @file uEspConfigLibSchema.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * \brief Option type: text
+ */
+#define uEspConfigLibSchema_TYPE_STRING 0
+/**
+ * \brief Option type: integer number
+ */
+#define uEspConfigLibSchema_TYPE_INT 1
+/**
+ * \brief Option type: boolean (0 or 1)
+ */
+#define uEspConfigLibSchema_TYPE_BOOL 2
+/**
+ * \brief Option type: decimal number
+ */
+#define uEspConfigLibSchema_TYPE_FLOAT 3
+
+struct uEspConfigLibSchemaOption {
+    const char * name;
+    const char * description;
+    const char * defaultValue;
+    uint8_t type;
+    uint8_t option;
+};
+
+struct uEspConfigLibSchema {
+    const uEspConfigLibSchemaOption * options;
+    uint16_t count;
+    const uint16_t * indexes;
+    const uint16_t * displacements;
+    uint16_t buckets;
+    uint32_t seed;
+};
+
+/**
+ * \brief Hashes an option name (FNV-1a, using seed as offset basis)
+ *
+ * @param name Option name
+ * @param seed Schema seed
+ * @return Hash
+ */
+inline uint32_t uEspConfigLibSchema_hash(const char * name, const uint32_t seed) {
+    uint32_t hash = seed;
+    for (; *name != 0; name++) {
+        hash = (hash ^ (uint8_t) *name) * 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * \brief Finds an option in a schema, using one hash and one compare
+ *
+ * @param schema Schema
+ * @param name Option name
+ * @return Option index, -1 if not found
+ */
+inline int uEspConfigLibSchema_find(const uEspConfigLibSchema * schema, const char * name) {
+    uint32_t hash;
+    uint32_t index;
+    if (schema->count == 0) {
+        return -1;
+    }
+    hash = uEspConfigLibSchema_hash(name, schema->seed);
+    index = (hash ^ (uint32_t) (schema->displacements[hash % schema->buckets] * 2654435761UL)) % schema->count;
+    index = schema->indexes[index];
+    return strcmp(schema->options[index].name, name) == 0 ? (int) index : -1;
+}
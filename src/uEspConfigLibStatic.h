@@ -0,0 +1,254 @@
+/**
+ * \class uEspConfigLibStatic
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Static capacity part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * This variant keeps up to MaxOptions options and all their strings in fixed arrays of StorageBytes bytes, without
+ * any heap use, so memory use is known at link time. Running out of space is reported as an error.
+ *
+ *
+ * @file uEspConfigLibStatic.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLib.h"
+#include "uEspConfigLibFSInterface.h"
+#include "uEspConfigLibParser.h"
+
+/**
+ * \brief Default bytes reserved for each value, including terminator, when not given on addOption
+ */
+#ifndef uEspConfigLibStatic_VALUE_SIZE
+    #define uEspConfigLibStatic_VALUE_SIZE 32
+#endif
+
+struct uEspConfigLibStaticEntry {
+    const char * name;
+    const char * description;
+    const char * defaultValue;
+    char * value;
+    uint16_t capacity;
+    uint8_t option;
+};
+
+template <uint16_t MaxOptions, size_t StorageBytes>
+class uEspConfigLibStatic {
+    public:
+        /**
+         * \brief Constructor
+         *
+         * @param fs Selected uEspConfigLibFSInterface to be used
+         */
+        uEspConfigLibStatic(uEspConfigLibFSInterface * fs) : _fs(fs), _count(0), _used(0) {};
+
+        /**
+         * \brief Defines a configuration option
+         *
+         * Name, description and default value are copied to static storage, and value space is reserved.
+         *
+         * @param name Name of configuration option
+         * @param description Description of the configuration option
+         * @param defaultValue Default value of the configuration option
+         * @param option Optional. Lets you specify extra features of this configuration option. i.e.: uEspConfigLib_OPTION_SCANNER for SSID scanner
+         * @param valueSize Optional. Bytes reserved for value, including terminator. Default uEspConfigLibStatic_VALUE_SIZE, never less than default value
+         * @return False on error (too many options, not enough storage, name already defined, or name or value longer than
+         *         loadConfigFile() reads without heap: uEspConfigLibParser_NAME_SIZE and uEspConfigLibParser_VALUE_SIZE)
+         */
+        bool addOption(const char * name, const char * description, const char * defaultValue, const uint8_t option = uEspConfigLib_OPTION_NONE, const uint16_t valueSize = uEspConfigLibStatic_VALUE_SIZE) {
+            uEspConfigLibStaticEntry * entry;
+            size_t capacity = strlen(defaultValue) + 1;
+            if (_count >= MaxOptions || _find(name) != 0) {
+                return false;
+            }
+            if (capacity < valueSize) {
+                capacity = valueSize;
+            }
+            if (strlen(name) >= uEspConfigLibParser_NAME_SIZE || capacity > uEspConfigLibParser_VALUE_SIZE) {
+                return false;
+            }
+            if (_used + strlen(name) + strlen(description) + strlen(defaultValue) + 3 + capacity > StorageBytes) {
+                return false;
+            }
+            entry = &_entries[_count];
+            entry->name = _store(name);
+            entry->description = _store(description);
+            entry->defaultValue = _store(defaultValue);
+            entry->value = _storage + _used;
+            entry->capacity = capacity;
+            entry->option = option;
+            _used += capacity;
+            strcpy(entry->value, defaultValue);
+            _count++;
+            return true;
+        };
+
+        /**
+         * \brief Changes a configuration option
+         *
+         * @param name Name of configuration option
+         * @param value New value of the configuration option
+         * @return False on error (name not defined previously or value longer than reserved space)
+         */
+        bool set(const char * name, const char * value) {
+            uEspConfigLibStaticEntry * entry = _find(name);
+            if (entry == 0 || strlen(value) >= entry->capacity) {
+                return false;
+            }
+            strcpy(entry->value, value);
+            return true;
+        };
+
+        /**
+         * \brief Gets a char pointer to the current value of a configuration option
+         *
+         * @param name Name of configuration option
+         * @return Char pointer. Null if not found.
+         */
+        char * getPointer(const char * name) {
+            uEspConfigLibStaticEntry * entry = _find(name);
+            return entry == 0 ? 0 : entry->value;
+        };
+
+        /**
+         * \brief Changes a configuration option to its default value
+         *
+         * @param name Name of configuration option
+         * @return False on error (name not defined previously)
+         */
+        bool clear(const char * name) {
+            uEspConfigLibStaticEntry * entry = _find(name);
+            if (entry == 0) {
+                return false;
+            }
+            strcpy(entry->value, entry->defaultValue);
+            return true;
+        };
+
+        /**
+         * \brief Loads config file from FileSystem and processes it
+         *
+         * Values longer than reserved space are ignored, keeping current value. Heap is never used: lines with names or
+         * values longer than parser buffers are discarded.
+         *
+         * @return False on error, including ignored values and discarded lines
+         */
+        bool loadConfigFile() {
+            uEspConfigLibParser parser(false);
+            char chunk[uEspConfigLib_READ_CHUNK_SIZE];
+            size_t len;
+            bool result = true;
+            if (!_fs->openToRead()) {
+                return false;
+            }
+            while ((len = _fs->read(chunk, uEspConfigLib_READ_CHUNK_SIZE)) > 0) {
+                for (size_t i = 0; i < len; i++) {
+                    if (parser.feed(chunk[i])) {
+                        result = _apply(&parser) && result;
+                    }
+                }
+                uEspConfigLibYield::step(len);
+            }
+            if (parser.finish()) {
+                result = _apply(&parser) && result;
+            }
+            _fs->closeFile();
+            return result && !parser.discarded();
+        };
+
+        /**
+         * \brief Recreates and overwrites config file to FileSystem with current configurations
+         *
+         * @return False on error, including write errors
+         */
+        bool saveConfigFile() {
+            const char * header[] = {
+                "# uConfigLib Configuration file\n",
+                "# Visit https://github.com/Naguissa/uEspConfigLib for details\n",
+                "# Syntax:\n",
+                "# variable = value\n",
+                "# (spaces and empty lines doesn't care)\n",
+                "# This file comments: lines starting with #, ; or //\n"
+            };
+            bool result = true;
+            if (!_fs->openToWrite()) {
+                return false;
+            }
+            for (uint8_t j = 0; j < sizeof(header) / sizeof(header[0]) && result; j++) {
+                result = _fs->write(header[j]);
+            }
+            for (uint16_t i = 0; i < _count && result; i++) {
+                const char * parts[] = {"\n# ", _entries[i].name, " -- ", _entries[i].description, "\n# Default value: ", _entries[i].defaultValue, "\n", _entries[i].name, " = ", _entries[i].value, "\n"};
+                size_t written = 0;
+                for (uint8_t j = 0; j < sizeof(parts) / sizeof(parts[0]) && result; j++) {
+                    result = _fs->write(parts[j]);
+                    written += strlen(parts[j]);
+                }
+                uEspConfigLibYield::step(written);
+            }
+            return _fs->closeFile() && result;
+        };
+
+        /**
+         * \brief Gets number of defined options
+         *
+         * @return Number of options
+         */
+        uint16_t count() { return _count; };
+
+        /**
+         * \brief Gets a defined option
+         *
+         * @param index Option index, from 0 to count() - 1
+         * @return Option entry. Null if out of range
+         */
+        const uEspConfigLibStaticEntry * entry(const uint16_t index) { return index < _count ? &_entries[index] : 0; };
+
+        /**
+         * \brief Gets free static storage
+         *
+         * @return Bytes still available for new options
+         */
+        size_t available() { return StorageBytes - _used; };
+
+    private:
+        uEspConfigLibStaticEntry * _find(const char * name) {
+            for (uint16_t i = 0; i < _count; i++) {
+                if (strcmp(_entries[i].name, name) == 0) {
+                    return &_entries[i];
+                }
+            }
+            return 0;
+        };
+
+        const char * _store(const char * value) {
+            char * stored = _storage + _used;
+            strcpy(stored, value);
+            _used += strlen(value) + 1;
+            return stored;
+        };
+
+        bool _apply(uEspConfigLibParser * parser) {
+            uEspConfigLibStaticEntry * entry = _find(parser->name());
+            if (entry == 0) { // Unknown options are ignored
+                return true;
+            }
+            return set(parser->name(), parser->value());
+        };
+
+        uEspConfigLibFSInterface * _fs;
+        uEspConfigLibStaticEntry _entries[MaxOptions];
+        char _storage[StorageBytes];
+        uint16_t _count;
+        size_t _used;
+};
@@ -0,0 +1,134 @@
+/**
+ * \class uEspConfigLibWebRequest
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Web request interface part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Web handlers read arguments and render their response through this interface, so they can be used with any web server.
+ *
+ * Currently web request classes are: WebServer / ESP8266WebServer, ESPAsyncWebServer and a mock for host-side tests.
+ *
+ *
+ * @file uEspConfigLibWebRequest.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+
+class uEspConfigLibStream {
+    public:
+        /**
+         * \brief Writes as much data as the connection takes without blocking
+         *
+         * @param data Data to write
+         * @param len Data length
+         * @return Bytes written, 0 if connection cannot take more data now
+         */
+        virtual size_t write(const char *, const size_t) = 0;
+
+        /**
+         * \brief Checks if connection is still open
+         *
+         * @return True if open
+         */
+        virtual bool connected() = 0;
+
+        /**
+         * \brief Destructor, closes connection
+         */
+        virtual ~uEspConfigLibStream() {};
+};
+
+class uEspConfigLibWebRequest {
+    public:
+        /**
+         * \brief Gets a request argument
+         *
+         * @param name Argument name
+         * @return Argument value, empty if not present
+         */
+        virtual String arg(const char *) = 0;
+
+        /**
+         * \brief Checks if a request argument is present
+         *
+         * @param name Argument name
+         * @return True if present, even if empty
+         */
+        virtual bool hasArg(const char *) = 0;
+
+        /**
+         * \brief Starts a streamed response of unknown length
+         *
+         * @param code HTTP status code
+         * @param contentType Content type
+         */
+        virtual void begin(const int, const char *) = 0;
+
+        /**
+         * \brief Sends a piece of response body, after begin()
+         *
+         * Implementations add sent length to _sent, used on metrics.
+         *
+         * @param data Text to send; empty text is ignored
+         */
+        virtual void sendContent(const char *) = 0;
+
+        /**
+         * \brief Sends a piece of response body, after begin()
+         *
+         * @param data Text to send; empty text is ignored
+         */
+        void sendContent(const String &data) { sendContent(data.c_str()); };
+
+        /**
+         * \brief Sends a piece of response body of given length, after begin()
+         *
+         * Data may contain null bytes. Implementations add sent length to _sent, used on metrics.
+         *
+         * @param data Data to send
+         * @param len Data length; 0 is ignored
+         */
+        virtual void sendContent(const char *, const size_t) = 0;
+
+        /**
+         * \brief Responds with a 302 redirect
+         *
+         * @param location Redirect destination
+         */
+        virtual void redirect(const char *) = 0;
+
+        /**
+         * \brief Ends the response started with begin()
+         */
+        virtual void end() {};
+
+        /**
+         * \brief Starts a 200 response that stays open after handler returns, to be written later from loop()
+         *
+         * @param contentType Content type
+         * @return Stream, to be deleted by caller. Null if not supported by this server or connection is closed
+         */
+        virtual uEspConfigLibStream * openStream(const char *) { return 0; };
+
+        /**
+         * \brief Returns response body bytes sent
+         *
+         * @return Bytes
+         */
+        size_t sentBytes() { return _sent; };
+
+        virtual ~uEspConfigLibWebRequest() {};
+
+    protected:
+        size_t _sent = 0;
+};
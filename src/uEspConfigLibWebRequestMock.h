@@ -0,0 +1,159 @@
+/**
+ * \class uEspConfigLibWebRequestMock
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Mock web request part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Request with arguments set by hand whose response is captured in memory, to test handlers without a web server.
+ * Used by host tests, see extras/tests.
+ *
+ *
+ * @file uEspConfigLibWebRequestMock.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLibWebRequest.h"
+
+/**
+ * \brief Maximum number of arguments of a mock request
+ */
+#ifndef uEspConfigLibWebRequestMock_MAX_ARGS
+    #define uEspConfigLibWebRequestMock_MAX_ARGS 16
+#endif
+
+class uEspConfigLibWebRequestMockStream : public uEspConfigLibStream {
+    public:
+        size_t write(const char * data, const size_t len) {
+            size_t written = len < room ? len : room;
+            body.concat(data, written);
+            room -= written;
+            return written;
+        };
+
+        bool connected() {
+            return open;
+        };
+
+        /**
+         * \brief Data written
+         */
+        String body;
+        /**
+         * \brief Bytes taken before the connection blocks; set it to simulate a slow client
+         */
+        size_t room = (size_t) -1;
+        /**
+         * \brief Set to false to simulate a closed connection: stream is deleted by its owner
+         */
+        bool open = true;
+};
+
+class uEspConfigLibWebRequestMock : public uEspConfigLibWebRequest {
+    public:
+        /**
+         * \brief Adds a request argument
+         *
+         * @param name Argument name
+         * @param value Argument value
+         * @return False on error (too many arguments)
+         */
+        bool setArg(const char * name, const char * value) {
+            if (_args >= uEspConfigLibWebRequestMock_MAX_ARGS) {
+                return false;
+            }
+            _names[_args] = name;
+            _values[_args] = value;
+            _args++;
+            return true;
+        };
+
+        String arg(const char * name) {
+            for (uint8_t i = 0; i < _args; i++) {
+                if (_names[i] == name) {
+                    return _values[i];
+                }
+            }
+            return String();
+        };
+
+        bool hasArg(const char * name) {
+            for (uint8_t i = 0; i < _args; i++) {
+                if (_names[i] == name) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        void begin(const int code, const char * contentType) {
+            this->code = code;
+            this->contentType = contentType;
+        };
+
+        using uEspConfigLibWebRequest::sendContent;
+        void sendContent(const char * data) {
+            body += data;
+            _sent += strlen(data);
+        };
+
+        void sendContent(const char * data, const size_t len) {
+            body.concat(data, len);
+            _sent += len;
+        };
+
+        void redirect(const char * location) {
+            code = 302;
+            this->location = location;
+        };
+
+        void end() {
+            ended = true;
+        };
+
+        uEspConfigLibStream * openStream(const char * contentType) {
+            code = 200;
+            this->contentType = contentType;
+            stream = new uEspConfigLibWebRequestMockStream();
+            return stream;
+        };
+
+        /**
+         * \brief Response HTTP status code, 0 if no response was sent
+         */
+        int code = 0;
+        /**
+         * \brief Response content type
+         */
+        String contentType;
+        /**
+         * \brief Redirect destination, if any
+         */
+        String location;
+        /**
+         * \brief Response body
+         */
+        String body;
+        /**
+         * \brief True when response has been ended
+         */
+        bool ended = false;
+        /**
+         * \brief Last stream opened, owned by handler: valid until closed with its open member
+         */
+        uEspConfigLibWebRequestMockStream * stream = 0;
+
+    private:
+        String _names[uEspConfigLibWebRequestMock_MAX_ARGS];
+        String _values[uEspConfigLibWebRequestMock_MAX_ARGS];
+        uint8_t _args = 0;
+};
@@ -0,0 +1,139 @@
+/**
+ * \class uEspConfigLibWebServerRequest
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - WebServer / ESP8266WebServer request part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Adapts the core WebServer (ESP32) or ESP8266WebServer (ESP8266) current request to uEspConfigLibWebRequest.
+ *
+ *
+ * @file uEspConfigLibWebServerRequest.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibWebServerRequest.h"
+#include "uEspConfigLibYield.h"
+#ifdef ARDUINO_ARCH_ESP32
+    #include <errno.h>
+    #include <lwip/sockets.h>
+#endif
+
+/**
+ * \brief Constructor
+ *
+ * @param server WebServer or ESP8266WebServer variable, depending on architecture
+ */
+uEspConfigLibWebServerRequest::uEspConfigLibWebServerRequest(uEspConfigLib_WebServer * server) {
+    _server = server;
+}
+
+String uEspConfigLibWebServerRequest::arg(const char * name) {
+    return _server->arg(name);
+}
+
+bool uEspConfigLibWebServerRequest::hasArg(const char * name) {
+    return _server->hasArg(name);
+}
+
+void uEspConfigLibWebServerRequest::begin(const int code, const char * contentType) {
+    _server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    yield();
+    _server->send(code, contentType, "");
+    yield();
+}
+
+void uEspConfigLibWebServerRequest::sendContent(const char * data) {
+    if (*data != 0) { // Empty chunk would end chunked response
+        size_t len = strlen(data);
+        _server->sendContent(data);
+        _sent += len;
+        uEspConfigLibYield::step(len);
+    }
+}
+
+void uEspConfigLibWebServerRequest::sendContent(const char * data, const size_t len) {
+    if (len > 0) { // Empty chunk would end chunked response
+        _server->sendContent(data, len);
+        _sent += len;
+        uEspConfigLibYield::step(len);
+    }
+}
+
+void uEspConfigLibWebServerRequest::redirect(const char * location) {
+    _server->sendHeader("Location", location, true);
+    _server->send(302, "text/html", "");
+}
+
+// Connection is handed over: WebServer drops its reference when handler returns without closing it, and the
+// response is delimited by connection close, so browser never sends another request that WebServer could read.
+// Headers are written here as WebServer send() would end the response when handler returns.
+uEspConfigLibStream * uEspConfigLibWebServerRequest::openStream(const char * contentType) {
+    WiFiClient client = _server->client();
+    if (!client.connected()) {
+        return 0;
+    }
+    client.setNoDelay(true);
+    uEspConfigLibClientStream * stream = new uEspConfigLibClientStream(client);
+    String headers = "HTTP/1.1 200 OK\r\nContent-Type: ";
+    headers += contentType;
+    headers += "\r\nCache-Control: no-cache\r\nConnection: close\r\nAccess-Control-Allow-Origin: *\r\n\r\n";
+    if (stream->write(headers.c_str(), headers.length()) != headers.length()) { // Empty send buffer always takes them
+        delete stream;
+        return 0;
+    }
+    return stream;
+}
+
+
+/**
+ * \brief Constructor
+ *
+ * @param client Connection to write to
+ */
+uEspConfigLibClientStream::uEspConfigLibClientStream(WiFiClient client) {
+    _client = client;
+    _failed = false;
+}
+
+/**
+ * \brief Destructor, closes connection
+ */
+uEspConfigLibClientStream::~uEspConfigLibClientStream() {
+    _client.stop();
+}
+
+// ESP8266 reports free send buffer. ESP32 WiFiClient write() waits for room, so socket is written directly instead
+size_t uEspConfigLibClientStream::write(const char * data, const size_t len) {
+    #ifdef ARDUINO_ARCH_ESP32
+        int fd = _client.fd();
+        if (fd < 0 || _failed) {
+            return 0;
+        }
+        int sent = send(fd, data, len, MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                _failed = true;
+            }
+            return 0;
+        }
+        return sent;
+    #else
+        int room = _client.availableForWrite();
+        if (room <= 0) {
+            return 0;
+        }
+        return _client.write((const uint8_t *) data, (size_t) room < len ? room : len);
+    #endif
+}
+
+bool uEspConfigLibClientStream::connected() {
+    return !_failed && _client.connected();
+}
@@ -0,0 +1,66 @@
+/**
+ * \class uEspConfigLibWebServerRequest
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - WebServer / ESP8266WebServer request part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Adapts the core WebServer (ESP32) or ESP8266WebServer (ESP8266) current request to uEspConfigLibWebRequest.
+ *
+ *
+ * @file uEspConfigLibWebServerRequest.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "uEspConfigLibWebRequest.h"
+#ifdef ARDUINO_ARCH_ESP32
+    #include "WebServer.h"
+    #define uEspConfigLib_WebServer WebServer
+#else
+    #include "ESP8266WebServer.h"
+    #define uEspConfigLib_WebServer ESP8266WebServer
+#endif
+
+class uEspConfigLibClientStream : public uEspConfigLibStream {
+    public:
+        uEspConfigLibClientStream(WiFiClient);
+        ~uEspConfigLibClientStream();
+
+        size_t write(const char *, const size_t);
+        bool connected();
+
+    private:
+        WiFiClient _client;
+        bool _failed;
+};
+
+class uEspConfigLibWebServerRequest : public uEspConfigLibWebRequest {
+    public:
+        /**
+         * \brief Constructor
+         *
+         * @param server WebServer or ESP8266WebServer variable, depending on architecture
+         */
+        uEspConfigLibWebServerRequest(uEspConfigLib_WebServer *);
+
+        String arg(const char *);
+        bool hasArg(const char *);
+        void begin(const int, const char *);
+        using uEspConfigLibWebRequest::sendContent;
+        void sendContent(const char *);
+        void sendContent(const char *, const size_t);
+        void redirect(const char *);
+        uEspConfigLibStream * openStream(const char *);
+
+    private:
+        uEspConfigLib_WebServer * _server;
+};
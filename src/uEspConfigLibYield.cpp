@@ -0,0 +1,57 @@
+/**
+ * \class uEspConfigLibYield
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Yield policy part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Long operations (page rendering, file load and save) report their work here and yield() is called only when a
+ * budget of bytes or time is used, instead of after every small operation.
+ *
+ *
+ * @file uEspConfigLibYield.cpp
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#include <Arduino.h>
+#include "uEspConfigLibYield.h"
+
+size_t uEspConfigLibYield::_budgetBytes = uEspConfigLibYield_BYTES;
+unsigned long uEspConfigLibYield::_budgetMicros = uEspConfigLibYield_MICROS;
+size_t uEspConfigLibYield::_bytes = 0;
+unsigned long uEspConfigLibYield::_start = 0;
+
+/**
+ * \brief Sets yield budget, shared by all library objects
+ *
+ * yield() is called when any of both limits is reached. Setting bytes to 0 yields on every step.
+ *
+ * @param bytes Bytes processed between yields, uEspConfigLibYield_BYTES by default
+ * @param micros Microseconds between yields, uEspConfigLibYield_MICROS by default
+ */
+void uEspConfigLibYield::setBudget(const size_t bytes, const unsigned long micros) {
+    _budgetBytes = bytes;
+    _budgetMicros = micros;
+}
+
+/**
+ * \brief Reports processed work, yielding if budget is used
+ *
+ * @param bytes Bytes processed since last step, 0 to check only time
+ */
+void uEspConfigLibYield::step(const size_t bytes) {
+    unsigned long now = micros();
+    _bytes += bytes;
+    if (_bytes < _budgetBytes && now - _start < _budgetMicros) {
+        return;
+    }
+    yield();
+    _bytes = 0;
+    _start = micros();
+}
@@ -0,0 +1,64 @@
+/**
+ * \class uEspConfigLibYield
+ * \brief The deffinitive ESP32 and ESP8266 configuration Arduino library, uEspConfigLib - Yield policy part
+ *
+ * This library consist in 2 parts:
+ *
+ * One main library, uEspConfigLib, that manages configuration options, defaults, configuration site (HTML and JSON), configuration processing (from a POST of previous site) and configuration storage.
+ *
+ * One interface to manage different configuration storages.
+ *
+ * Long operations (page rendering, file load and save) report their work here and yield() is called only when a
+ * budget of bytes or time is used, instead of after every small operation.
+ *
+ *
+ * @file uEspConfigLibYield.h
+ * @copyright Naguissa
+ * @author Naguissa
+ * @see <a href="https://github.com/Naguissa/uEspConfigLib">https://github.com/Naguissa/uEspConfigLib</a>
+ * @see <a href="mailto:naguissa@foroelectro.net">naguissa@foroelectro.net</a>
+ * @version 1.2.0
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * \brief Default bytes processed between yields
+ */
+#ifndef uEspConfigLibYield_BYTES
+    #define uEspConfigLibYield_BYTES 1024
+#endif
+
+/**
+ * \brief Default microseconds between yields
+ */
+#ifndef uEspConfigLibYield_MICROS
+    #define uEspConfigLibYield_MICROS 2000
+#endif
+
+class uEspConfigLibYield {
+    public:
+        /**
+         * \brief Sets yield budget, shared by all library objects
+         *
+         * yield() is called when any of both limits is reached. Setting bytes to 0 yields on every step.
+         *
+         * @param bytes Bytes processed between yields, uEspConfigLibYield_BYTES by default
+         * @param micros Microseconds between yields, uEspConfigLibYield_MICROS by default
+         */
+        static void setBudget(const size_t, const unsigned long);
+
+        /**
+         * \brief Reports processed work, yielding if budget is used
+         *
+         * @param bytes Bytes processed since last step, 0 to check only time
+         */
+        static void step(const size_t);
+
+    private:
+        static size_t _budgetBytes;
+        static unsigned long _budgetMicros;
+        static size_t _bytes;
+        static unsigned long _start;
+};